@@ -0,0 +1,247 @@
+#include "adaptive_sampler.h"
+#include "solver.h"
+#include "sweep_parameter.h"
+#include "util.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <set>
+
+namespace
+{
+    // Integer coordinates on the finest grid, the second one is always 0 for 1D sweeps
+    using Lattice = std::array<int, 2>;
+
+    struct Cell
+    {
+        Lattice origin;
+        int size;
+        int depth;
+    };
+
+    // Outputs that drive refinement: steady ω, drag and torque. The net torque averages to zero at steady
+    // state, so the aerodynamic torque absorbed by the motor is used instead of it.
+    constexpr size_t OutputCount = 3;
+
+    // Slope sign flips smaller than this fraction of the refinement threshold are treated as noise
+    constexpr float NoiseFraction = 0.2f;
+
+    std::array<float, OutputCount> outputsOf(const SteadyState& state)
+    {
+        return {state.angularVelocity, state.drag, state.aerodynamicTorque};
+    }
+
+    class Sampler
+    {
+        public:
+            Sampler(const Configuration& configuration, const AdaptiveSweepSettings& settings, std::atomic<float>& progress)
+                : m_configuration(configuration), m_settings(settings), m_progress(progress) {}
+
+            SweepResult run()
+            {
+                const int dimensions = std::clamp(m_settings.dimensions, 1, 2);
+                const int divisions = std::max(m_settings.initialDivisions, 1);
+                const int coarse = 1 << std::max(m_settings.maxDepth, 0);
+                m_dimensions = dimensions;
+                m_finest = divisions * coarse;
+
+                // Coarse grid
+                std::vector<Lattice> points;
+                std::vector<Cell> cells;
+                for (int i = 0; i <= divisions; ++i)
+                {
+                    for (int j = 0; j <= (dimensions == 2 ? divisions : 0); ++j)
+                    {
+                        points.push_back({i * coarse, j * coarse});
+                        if (i < divisions && (dimensions == 1 || j < divisions)) cells.push_back({{i * coarse, j * coarse}, coarse, 0});
+                    }
+                }
+                evaluate(points, 0);
+
+                // Level synchronous refinement, every pass solves all new corners of the cells it splits in parallel
+                while (!cells.empty())
+                {
+                    updateRanges();
+
+                    std::vector<Cell> refined;
+                    std::set<Lattice> queued;
+                    points.clear();
+
+                    for (const Cell& cell : cells)
+                    {
+                        if (cell.depth >= m_settings.maxDepth || !needsRefinement(cell)) continue;
+
+                        const int half = cell.size / 2;
+                        for (int dx = 0; dx <= half; dx += half)
+                        {
+                            for (int dy = 0; dy <= (dimensions == 2 ? half : 0); dy += half)
+                            {
+                                const Cell child = {{cell.origin[0] + dx, cell.origin[1] + dy}, half, cell.depth + 1};
+                                refined.push_back(child);
+                                for (const Lattice& corner : corners(child))
+                                {
+                                    if (!m_index.count(corner) && queued.insert(corner).second) points.push_back(corner);
+                                }
+                            }
+                        }
+                    }
+
+                    if (!points.empty()) evaluate(points, refined.front().depth);
+                    cells = std::move(refined);
+                }
+
+                SweepResult result;
+                result.settings = m_settings;
+                result.samples = std::move(m_samples);
+                std::sort(result.samples.begin(), result.samples.end(), [](const SweepSample& a, const SweepSample& b) { return a.point < b.point; });
+                result.denseSolves = static_cast<size_t>(std::pow(m_finest + 1, dimensions));
+                return result;
+            }
+
+        private:
+            std::array<float, 2> pointAt(const Lattice& lattice) const
+            {
+                std::array<float, 2> point = {0, 0};
+                for (int a = 0; a < m_dimensions; ++a)
+                {
+                    const SweepAxis& axis = m_settings.axes[a];
+                    point[a] = axis.min + (axis.max - axis.min) * lattice[a] / m_finest;
+                }
+                return point;
+            }
+
+            void evaluate(const std::vector<Lattice>& points, int depth)
+            {
+                const size_t first = m_samples.size();
+                for (const Lattice& lattice : points)
+                {
+                    m_index[lattice] = m_samples.size();
+                    m_samples.push_back({pointAt(lattice), {}, depth, {}});
+                }
+
+                std::atomic<size_t> completed = 0;
+                m_progress = 0;
+                Util::parallelFor(points.size(), [&](size_t i) {
+                    SweepSample& sample = m_samples[first + i];
+                    Configuration configuration = m_configuration;
+                    for (int a = 0; a < m_dimensions; ++a)
+                    {
+                        SweepParameters::All[m_settings.axes[a].parameter].apply(configuration, sample.point[a]);
+                    }
+
+                    std::atomic<float> solveProgress = 0;
+                    Solution solution = Solver::solve(configuration, solveProgress, nullptr, nullptr, nullptr, &m_pool);
+                    sample.state = solution.steadyState();
+                    sample.cycles = std::move(solution.cycles);
+                    m_pool.release(std::move(solution));
+                    m_progress = static_cast<float>(++completed) / points.size();
+                });
+            }
+
+            void updateRanges()
+            {
+                for (size_t k = 0; k < OutputCount; ++k)
+                {
+                    float lo = std::numeric_limits<float>::max(), hi = std::numeric_limits<float>::lowest();
+                    for (const SweepSample& sample : m_samples)
+                    {
+                        const float value = outputsOf(sample.state)[k];
+                        lo = std::min(lo, value);
+                        hi = std::max(hi, value);
+                    }
+                    m_ranges[k] = hi - lo;
+                }
+            }
+
+            std::vector<Lattice> corners(const Cell& cell) const
+            {
+                std::vector<Lattice> result = {cell.origin, {cell.origin[0] + cell.size, cell.origin[1]}};
+                if (m_dimensions == 2)
+                {
+                    result.push_back({cell.origin[0], cell.origin[1] + cell.size});
+                    result.push_back({cell.origin[0] + cell.size, cell.origin[1] + cell.size});
+                }
+                return result;
+            }
+
+            const SweepSample* find(const Lattice& lattice) const
+            {
+                auto it = m_index.find(lattice);
+                return it == m_index.end() ? nullptr : &m_samples[it->second];
+            }
+
+            bool needsRefinement(const Cell& cell) const
+            {
+                const std::vector<Lattice> cellCorners = corners(cell);
+
+                for (size_t k = 0; k < OutputCount; ++k)
+                {
+                    if (!(m_ranges[k] > 0)) continue;
+                    const float threshold = m_settings.tolerance * m_ranges[k];
+                    const float noise = NoiseFraction * threshold;
+                    auto value = [&](const SweepSample* sample) { return outputsOf(sample->state)[k]; };
+
+                    // Sharp change across the cell
+                    float lo = std::numeric_limits<float>::max(), hi = std::numeric_limits<float>::lowest();
+                    for (const Lattice& corner : cellCorners)
+                    {
+                        const float v = value(find(corner));
+                        lo = std::min(lo, v);
+                        hi = std::max(hi, v);
+                    }
+                    if (hi - lo > threshold) return true;
+
+                    // Non-monotonic: the slope along an axis flips sign between this cell and a same sized neighbour
+                    for (int a = 0; a < m_dimensions; ++a)
+                    {
+                        for (const Lattice& lower : cellCorners)
+                        {
+                            if (lower[a] != cell.origin[a]) continue;
+
+                            Lattice upper = lower, before = lower, after = lower;
+                            upper[a] += cell.size;
+                            before[a] -= cell.size;
+                            after[a] += 2 * cell.size;
+
+                            const float slope = value(find(upper)) - value(find(lower));
+                            if (std::abs(slope) < noise) continue;
+
+                            if (const SweepSample* sample = find(before))
+                            {
+                                const float previous = value(find(lower)) - value(sample);
+                                if (slope * previous < 0 && std::abs(previous) >= noise) return true;
+                            }
+                            if (const SweepSample* sample = find(after))
+                            {
+                                const float next = value(sample) - value(find(upper));
+                                if (slope * next < 0 && std::abs(next) >= noise) return true;
+                            }
+                        }
+                    }
+                }
+                return false;
+            }
+
+        private:
+            const Configuration& m_configuration;
+            const AdaptiveSweepSettings& m_settings;
+            std::atomic<float>& m_progress;
+
+            int m_dimensions = 1;
+            int m_finest = 1;
+            std::map<Lattice, size_t> m_index;
+            std::vector<SweepSample> m_samples;
+            std::array<float, OutputCount> m_ranges = {0, 0, 0};
+
+            // Every sample of a sweep has the same length, so its solves recycle each other's buffers
+            SolutionPool m_pool;
+    };
+}
+
+SweepResult AdaptiveSampler::run(const Configuration configuration, const AdaptiveSweepSettings settings, std::atomic<float>& progress)
+{
+    Sampler sampler(configuration, settings, progress);
+    return sampler.run();
+}
@@ -0,0 +1,58 @@
+#ifndef _ADAPTIVE_SAMPLER_H_
+#define _ADAPTIVE_SAMPLER_H_
+
+#include <array>
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "configuration.h"
+#include "solution.h"
+
+struct SweepAxis
+{
+    int parameter = 0; // Index into SweepParameters::All
+    float min = 40;
+    float max = 120;
+};
+
+struct AdaptiveSweepSettings
+{
+    int dimensions = 1; // 1 or 2
+    std::array<SweepAxis, 2> axes = {{{0, 40, 120}, {1, -0.3f, 0.3f}}};
+    int initialDivisions = 4;
+    int maxDepth = 4;
+
+    // Refine where steady ω, drag or aerodynamic torque changes by more than this fraction of its range across a cell
+    float tolerance = 0.05f;
+};
+
+struct SweepSample
+{
+    std::array<float, 2> point = {0, 0};
+    SteadyState state;
+    int depth = 0;
+
+    // Kept in place of the time series, which go back to the pool
+    CycleStatistics cycles;
+};
+
+struct SweepResult
+{
+    AdaptiveSweepSettings settings;
+    std::vector<SweepSample> samples;
+
+    // Solves a uniform grid at the finest refinement would need
+    size_t denseSolves = 0;
+};
+
+// Samples steady state outputs over one or two Configuration parameters.
+// Starts from a coarse grid and recursively subdivides cells where the outputs change sharply or
+// non-monotonically, so thresholds such as the switch between reversed and forward flow dominated
+// autorotation get the resolution of a dense grid while flat regions stay coarse.
+namespace AdaptiveSampler
+{
+    SweepResult run(const Configuration configuration, const AdaptiveSweepSettings settings, std::atomic<float>& progress);
+}
+
+#endif // _ADAPTIVE_SAMPLER_H_
@@ -1,24 +1,46 @@
 #include "aero_coefficient_interpolator.h"
 #include <algorithm>
-#include <limits>
+#include <bit>
+
+namespace {
+    // Order preserving map of floats to unsigned integers
+    uint32_t orderedBits(float value) {
+        const uint32_t bits = std::bit_cast<uint32_t>(value);
+        return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+    }
+}
 
 AeroCoefficientInterpolator::AeroCoefficientInterpolator(const CoefficientData& coefData)
     : data(coefData) {
-    // Sort data by alpha for each Reynolds number
+    // Sort data by alpha for each Reynolds number, a Reynolds number without points has nothing to interpolate
+    std::erase_if(data, [](const auto& reEntry) { return reEntry.second.empty(); });
     for (auto& reEntry : data) {
         std::sort(reEntry.second.begin(), reEntry.second.end());
+        reynolds.push_back(reEntry.first);
+        tables.push_back(reEntry.second);
     }
-}
 
-float AeroCoefficientInterpolator::lerp(float x1, float x2, float y1, float y2, float x) const {
-    if (x2 == x1) return y1;
-    return y1 + (y2 - y1) * (x - x1) / (x2 - x1);
+    if (reynolds.size() < 2) return;
+
+    // About four bins per table, so most lookups land in their bracket or the next
+    binOrigin = orderedBits(reynolds.front());
+    const uint32_t span = orderedBits(reynolds.back()) - binOrigin;
+    const uint32_t target = std::max<uint32_t>(16, 4 * static_cast<uint32_t>(reynolds.size()));
+    while ((span >> binShift) >= target) ++binShift;
+
+    bins.resize((span >> binShift) + 1);
+    uint32_t j = 0;
+    for (uint32_t k = 0; k < bins.size(); ++k) {
+        const uint32_t start = binOrigin + (k << binShift);
+        while (j + 1 < reynolds.size() && orderedBits(reynolds[j + 1]) <= start) ++j;
+        bins[k] = j;
+    }
 }
 
 float AeroCoefficientInterpolator::interpolateAtReynolds(float alpha,
                                                        const std::vector<std::pair<float, float>>& dataset) const {
     if (dataset.empty()) {
-        // No data: handled by caller (findClosestPoint or fallback to 0.0)
+        // No data: handled by caller (fallback to 0.0)
         return 0.0f;
     }
 
@@ -49,59 +71,34 @@ float AeroCoefficientInterpolator::interpolateAtReynolds(float alpha,
     return lerp(alpha1, alpha2, coef1, coef2, alpha);
 }
 
-float AeroCoefficientInterpolator::findClosestPoint(float alpha, float reynolds) const {
-    float minDistance = std::numeric_limits<float>::max();
-    float closestCoef = 0.0f;
-
-    for (const auto& reEntry : data) {
-        float re = reEntry.first;
-        const auto& points = reEntry.second;
-        for (const auto& point : points) {
-            float a = point.first;
-            float coef = point.second;
-            // Compute normalized distance (assuming Reynolds is on a logarithmic scale)
-            float reDistance = std::log10(reynolds / re);
-            float alphaDistance = alpha - a;
-            float distance = std::sqrt(alphaDistance * alphaDistance + reDistance * reDistance);
-            if (distance < minDistance) {
-                minDistance = distance;
-                closestCoef = coef;
-            }
-        }
-    }
-
-    return closestCoef;
+size_t AeroCoefficientInterpolator::reynoldsIndex(float re) const {
+    size_t j = bins[(orderedBits(re) - binOrigin) >> binShift];
+    while (reynolds[j + 1] <= re) ++j;
+    return j;
 }
 
-float AeroCoefficientInterpolator::coefficientAt(float alpha, float reynolds) const {
-    if (data.empty()) {
+float AeroCoefficientInterpolator::coefficientAt(float alpha, float re) const {
+    if (tables.empty()) {
         // No data at all: return 0.0 as last resort
         return 0.0f;
     }
 
-    // Find bracketing Reynolds numbers
-    auto it2 = data.lower_bound(reynolds);
-    if (it2 == data.end()) {
-        // Reynolds is above highest: use highest Reynolds data
-        return interpolateAtReynolds(alpha, data.rbegin()->second);
-    }
-    if (it2 == data.begin()) {
-        // Reynolds is below lowest: use lowest Reynolds data
-        return interpolateAtReynolds(alpha, data.begin()->second);
-    }
+    // Outside the Reynolds range: use the closest Reynolds data (NaN takes the lowest)
+    if (!(re > reynolds.front())) return interpolateAtReynolds(alpha, tables.front());
+    if (re >= reynolds.back()) return interpolateAtReynolds(alpha, tables.back());
 
-    // Try to interpolate between bracketing Reynolds numbers
-    float re1 = std::prev(it2)->first;
-    float re2 = it2->first;
-    const auto& data1 = std::prev(it2)->second;
-    const auto& data2 = it2->second;
+    // Interpolate between bracketing Reynolds numbers, a table of a single point is constant in alpha
+    const size_t j = reynoldsIndex(re);
+    float coef1 = interpolateAtReynolds(alpha, tables[j]);
+    float coef2 = interpolateAtReynolds(alpha, tables[j + 1]);
+    return lerp(reynolds[j], reynolds[j + 1], coef1, coef2, re);
+}
 
-    // If either dataset is empty or has insufficient points, find closest point
-    if (data1.empty() || data1.size() < 2 || data2.empty() || data2.size() < 2) {
-        return findClosestPoint(alpha, reynolds);
+std::vector<float> AeroCoefficientInterpolator::coefficientsAt(float alpha) const {
+    std::vector<float> column;
+    column.reserve(tables.size());
+    for (const auto& table : tables) {
+        column.push_back(interpolateAtReynolds(alpha, table));
     }
-
-    float coef1 = interpolateAtReynolds(alpha, data1);
-    float coef2 = interpolateAtReynolds(alpha, data2);
-    return lerp(re1, re2, coef1, coef2, reynolds);
+    return column;
 }
\ No newline at end of file
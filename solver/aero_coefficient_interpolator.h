@@ -1,6 +1,8 @@
 #ifndef _AERO_COEFFICIENT_INTERPOLATOR_H_
 #define _AERO_COEFFICIENT_INTERPOLATOR_H_
 
+#include <cstdint>
+#include <limits>
 #include <vector>
 #include <map>
 #include <cmath>
@@ -16,6 +18,26 @@ public:
     // Get coefficient at given alpha and Reynolds number
     float coefficientAt(float alpha, float reynolds) const;
 
+    // Coefficient at alpha of every Reynolds number, ascending. Callers whose alpha stays fixed keep this column
+    // and look up with segmentAt, which only has to bracket the Reynolds number.
+    std::vector<float> coefficientsAt(float alpha) const;
+
+    // Interpolation operands of coefficientAt(alpha, reynolds) for the alpha of column: the coefficient is
+    // y1 + (y2 - y1) * (reynolds - x1) / (x2 - x1) for every Reynolds number in [lower, upper), outside the Reynolds
+    // range both ends hold the closest coefficient. Lets the blade kernels keep each section's segment and
+    // interpolate several sections at once until their Reynolds numbers leave it.
+    struct Segment {
+        float lower = -std::numeric_limits<float>::infinity(), upper = std::numeric_limits<float>::infinity();
+        float x1 = 0.0f, x2 = 1.0f, y1 = 0.0f, y2 = 0.0f;
+    };
+    Segment segmentAt(const float* column, float reynolds) const;
+
+    const CoefficientData& coefficients() const { return data; }
+    const std::vector<float>& reynoldsNumbers() const { return reynolds; }
+
+    // True when coefficientAt does not depend on Reynolds number (at most one Reynolds entry)
+    bool reynoldsIndependent() const { return reynolds.size() <= 1; }
+
     // Static instances for DAE-51 airfoil
     static const AeroCoefficientInterpolator Dae51Lift;
     static const AeroCoefficientInterpolator Dae51Drag;
@@ -26,17 +48,49 @@ private:
     // Data: Reynolds -> vector of {alpha, coefficient}
     CoefficientData data;
 
+    // The same tables indexed by position, ascending Reynolds number, without empty tables
+    std::vector<float> reynolds;
+    std::vector<std::vector<std::pair<float, float>>> tables;
+
+    // Log spaced Reynolds bins. Floats order like their bit patterns (with the sign flipped), which grow close to
+    // linearly with log2 for positive values, so a bin is an integer subtraction and shift away. Each bin holds the
+    // table at or below its start, a step or two from the bracket.
+    uint32_t binOrigin = 0;
+    int binShift = 0;
+    std::vector<uint32_t> bins;
+
     // Linear interpolation
     float lerp(float x1, float x2, float y1, float y2, float x) const;
 
-    // Interpolate for a specific Reynolds number or find closest point
+    // Interpolate for a specific Reynolds number
     float interpolateAtReynolds(float alpha,
                                const std::vector<std::pair<float, float>>& dataset) const;
 
-    // Find the closest data point across all Reynolds numbers
-    float findClosestPoint(float alpha, float reynolds) const;
+    // Table j with reynolds[j] <= re < reynolds[j + 1], for re in [reynolds.front(), reynolds.back())
+    size_t reynoldsIndex(float re) const;
 };
 
+inline float AeroCoefficientInterpolator::lerp(float x1, float x2, float y1, float y2, float x) const {
+    if (x2 == x1) return y1;
+    return y1 + (y2 - y1) * (x - x1) / (x2 - x1);
+}
+
+inline AeroCoefficientInterpolator::Segment AeroCoefficientInterpolator::segmentAt(const float* column, float re) const {
+    Segment segment;
+    if (tables.empty()) return segment;
+    if (!(re >= reynolds.front())) {
+        segment.upper = reynolds.front();
+        segment.y1 = segment.y2 = column[0];
+    } else if (re >= reynolds.back()) {
+        segment.lower = reynolds.back();
+        segment.y1 = segment.y2 = column[tables.size() - 1];
+    } else {
+        const size_t j = reynoldsIndex(re);
+        segment = {reynolds[j], reynolds[j + 1], reynolds[j], reynolds[j + 1], column[j], column[j + 1]};
+    }
+    return segment;
+}
+
 // Inline static instance definitions
 inline const AeroCoefficientInterpolator AeroCoefficientInterpolator::Dae51Lift(
     CoefficientData{
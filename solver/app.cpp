@@ -3,6 +3,7 @@
 #include "app.h"
 #include "imgui.h"
 #include "solver.h"
+#include "sweep_parameter.h"
 
 App::App() : Window("Propeller Crossflow Autorotation Solver", 2200, 980) {}
 
@@ -27,6 +28,18 @@ void App::update()
     ImGui::InputFloat("Time Step (s)", &m_configuration.timeStep, 0.0F, 0.0F, "%.5f");
     ImGui::InputFloat("Radial Step (m)", &m_configuration.radialStep, 0.0F, 0.0F, "%.5f");
 
+    int currentQuadrature = static_cast<int>(m_configuration.radialQuadrature);
+    if (ImGui::Combo("Radial Quadrature", &currentQuadrature, RadialQuadratureNames.data(), static_cast<int>(RadialQuadratureNames.size()))) {
+        m_configuration.radialQuadrature = static_cast<RadialQuadrature>(currentQuadrature);
+    }
+    if (ImGui::IsItemHovered())
+    {
+        // Measured against a 26400 station reference, see tests/quadrature_convergence.cpp
+        ImGui::SetTooltip("Gauss-Legendre only pays off on coarse blades (about 8 to 16 stations), mostly in drag.\n"
+                          "From about 16 stations midpoint is as accurate in torque: the chord and pitch tables are\n"
+                          "piecewise linear, and their kinks limit every scheme. Tip-clustered cosine is no better than midpoint.");
+    }
+
     ImGui::PushFont(io.Fonts->Fonts[1]);
     ImGui::SeparatorText("Flight Conditions");
     ImGui::PopFont();
@@ -94,53 +107,834 @@ void App::update()
     ImGui::PushFont(io.Fonts->Fonts[1]);
     ImGui::SeparatorText("Solver and Solutions");
     ImGui::PopFont();
+    ImGui::Checkbox("Parallel Sections", &m_parallelSections);
+    ImGui::SameLine();
+    ImGui::Checkbox("Capture Sectional Loads", &m_captureSectionalLoads);
+    if (m_captureSectionalLoads)
+    {
+        ImGui::SameLine();
+        ImGui::SetNextItemWidth(100);
+        ImGui::InputInt("Decimation", &m_captureSettings.decimation);
+        if(m_captureSettings.decimation < 1) m_captureSettings.decimation = 1;
+    }
+    ImGui::SameLine();
+    ImGui::Checkbox("Auto-Solve", &m_autoSolve);
+    if (m_autoSolve && !(m_configuration == m_editedConfiguration))
+    {
+        m_editedConfiguration = m_configuration;
+        m_lastEdit = std::chrono::steady_clock::now();
+        requestSolve(true, PreviewDelay);
+    }
+
+    // A click while solving restarts the solve with the current configuration
     if (ImGui::Button("Solve"))
     {
-        if (!(m_future.valid() && m_future.wait_for(std::chrono::seconds(0)) != std::future_status::ready))
-        {
-            m_future = std::async(std::launch::async, Solver::solve, m_configuration, std::ref(m_progress));
-        }
+        m_editedConfiguration = m_configuration;
+        requestSolve(false, 0.0f);
     }
     ImGui::SameLine();
     if(ImGui::Button("Save"))
     {
-        if(m_selectedSolution != -1)
+        const Solution* solution = m_selectedSolution != -1 ? m_solutions.get(m_selectedSolution) : nullptr;
+        if(solution)
         {
-            Util::writeSolutionToCsv(m_solutions[m_selectedSolution]);
+            Util::writeSolutionToCsv(*solution);
         }
     }
 
-    if (m_future.valid() && m_future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    updateSolve();
+    if (isSolving())
     {
+        if (!m_solvingPreview) drainStream();
         ImGui::SameLine();
         ImGui::PushItemWidth(ImGui::GetContentRegionAvail().x);
-        ImGui::ProgressBar(m_progress, ImVec2(0.0f, 0.0f));
+        ImGui::ProgressBar(m_progress, ImVec2(0.0f, 0.0f), m_solvingPreview ? "Preview" : nullptr);
     }
-    else if (m_future.valid() && m_future.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+    else if (m_capture && !m_capture->filepath().empty())
     {
-        m_solutions.push_back(m_future.get());
-        m_selectedSolution = m_solutions.size() - 1;
-        m_configuration = m_solutions[m_selectedSolution].configuration;
+        // The writer lives until the next solve, its file is read back with the sections mode
+        ImGui::TextDisabled("Sectional loads captured to %s, export with: solver sections %s", m_capture->filepath().c_str(), m_capture->filepath().c_str());
+    }
+
+    ImGui::Checkbox("Overlay Solutions", &m_overlay);
+    m_overlaid.resize(m_solutions.size(), false);
+    if (m_overlay)
+    {
+        ImGui::SameLine();
+        if (ImGui::SmallButton("All")) m_overlaid.assign(m_overlaid.size(), true);
+        ImGui::SameLine();
+        if (ImGui::SmallButton("None")) m_overlaid.assign(m_overlaid.size(), false);
     }
 
     int newSelection = m_selectedSolution;
     for(int i = 0; i < m_solutions.size(); ++i)
     {
-        ImGui::RadioButton(m_solutions[i].name.c_str(), &newSelection, i);
+        if (m_overlay)
+        {
+            bool overlaid = m_overlaid[i];
+            ImGui::PushID(i);
+            if (ImGui::Checkbox("##Overlay", &overlaid)) m_overlaid[i] = overlaid;
+            ImGui::PopID();
+            ImGui::SameLine();
+        }
+        ImGui::RadioButton(m_solutions.name(i).c_str(), &newSelection, i);
+    }
+    if (m_selectedSolution != -1 && !m_solutions.error(m_selectedSolution).empty())
+    {
+        ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "%s", m_solutions.error(m_selectedSolution).c_str());
+    }
+
+    if (m_overlay)
+    {
+        std::vector<size_t> overlaid;
+        for (size_t i = 0; i < m_overlaid.size(); ++i)
+        {
+            if (m_overlaid[i]) overlaid.push_back(i);
+        }
+        if (m_overlayCache.update(overlaid, m_solutions)) m_fitPlots = true;
     }
     if(newSelection != m_selectedSolution)
     {
-        m_configuration = m_solutions[newSelection].configuration;
+        m_configuration = m_solutions.configuration(newSelection);
+        m_editedConfiguration = m_configuration;
         m_selectedSolution = newSelection;
+
+        // A running full solve still lands in the list, previews and pending requests were for the configuration left behind
+        m_selectResult = false;
+        m_pendingPreview.reset();
+        if (m_future.valid() && m_solvingPreview)
+        {
+            ++m_solveGeneration;
+            m_cancel = true;
+        }
+        m_showPreview = false;
+        m_fitPlots = true;
     }
 
+    renderSteadySolver();
+    renderSweep();
+    renderSurrogate();
+    renderConvergence();
+    renderParareal();
+    renderMultiRotor();
+    renderPolarImport();
+    renderSpectrum();
+    renderCycles();
 
     ImGui::NextColumn();
     renderPlots(m_PlotConfigsColumn1);
     ImGui::NextColumn();
     renderPlots(m_PlotConfigsColumn2);
+    if(!isSolving()) m_fitPlots = false;
 
     ImGui::PopFont();
     
     ImGui::End();
+}
+
+bool App::isBusy() const
+{
+    // Futures stay valid until their result is collected, which keeps frames coming until update() has taken it.
+    // A delayed solve needs frames too, to start once it is due.
+    return m_future.valid() || m_pendingPreview.has_value() || m_sweepFuture.valid() || m_surrogateFuture.valid() || m_convergenceFuture.valid() || m_pararealFuture.valid() || m_aircraftFuture.valid() || m_polarFuture.valid();
+}
+
+void App::requestSolve(bool preview, float delay)
+{
+    ++m_solveGeneration;
+    m_pendingPreview = preview;
+    m_pendingStart = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(delay));
+    // A finished job that has not been collected yet is superseded too
+    if (m_future.valid()) m_cancel = true;
+}
+
+void App::updateSolve()
+{
+    if (m_future.valid() && m_future.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+    {
+        Solution solution = m_future.get();
+        if (m_jobGeneration != m_solveGeneration)
+        {
+            // Superseded by a newer request, the (possibly partial) result is dropped
+            m_cancel = false;
+        }
+        else if (m_solvingPreview)
+        {
+            m_preview = std::move(solution);
+            m_showPreview = true;
+            m_fitPlots = true;
+
+            // The full solve follows once the edits have stopped
+            if (m_autoSolve && !m_pendingPreview)
+            {
+                m_pendingPreview = false;
+                m_pendingStart = m_lastEdit + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(FullSolveDelay));
+            }
+        }
+        else
+        {
+            m_solutions.add(std::move(solution));
+            if (m_selectResult)
+            {
+                m_selectedSolution = m_solutions.size() - 1;
+                m_showPreview = false;
+                m_fitPlots = true;
+            }
+        }
+    }
+
+    if (!m_future.valid() && m_pendingPreview && std::chrono::steady_clock::now() >= m_pendingStart)
+    {
+        startSolve(*m_pendingPreview);
+        m_pendingPreview.reset();
+    }
+}
+
+void App::startSolve(bool preview)
+{
+    m_solvingPreview = preview;
+    m_jobGeneration = m_solveGeneration;
+    m_selectResult = !preview;
+    m_cancel = false;
+    if (preview)
+    {
+        // Previews are not streamed, the plots keep the last result until the preview replaces it
+        m_future = std::async(std::launch::async, Solver::solve, Solver::preview(m_configuration, m_previewFidelity), std::ref(m_progress), nullptr, nullptr,
+                              m_parallelSections ? m_team.get() : nullptr, nullptr, &m_cancel);
+        return;
+    }
+
+    m_stream.clear();
+    m_liveSolution = Solution();
+    m_liveSolution.name = "solving";
+    m_liveSolution.color = ImVec4(1.0f, 1.0f, 1.0f, 1.0f);
+    m_capture = m_captureSectionalLoads ? std::make_unique<SectionalLoadWriter>(m_captureSettings) : nullptr;
+    if (m_parallelSections && !m_team) m_team = std::make_unique<WorkerTeam>();
+    m_future = std::async(std::launch::async, Solver::solve, m_configuration, std::ref(m_progress), &m_stream, m_capture.get(),
+                          m_parallelSections ? m_team.get() : nullptr, nullptr, &m_cancel);
+}
+
+bool App::isSolving() const
+{
+    return m_future.valid() && m_future.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+}
+
+void App::drainStream()
+{
+    SolutionSample sample;
+    while (m_stream.pop(sample))
+    {
+        m_liveSolution.append(sample);
+    }
+}
+
+void App::renderSweep()
+{
+    if (!ImGui::CollapsingHeader("Adaptive Sweep")) return;
+
+    std::vector<const char*> parameterNames;
+    for (const SweepParameter& parameter : SweepParameters::All) parameterNames.push_back(parameter.name.c_str());
+
+    ImGui::RadioButton("1D", &m_sweepSettings.dimensions, 1);
+    ImGui::SameLine();
+    ImGui::RadioButton("2D", &m_sweepSettings.dimensions, 2);
+
+    for (int a = 0; a < m_sweepSettings.dimensions; ++a)
+    {
+        SweepAxis& axis = m_sweepSettings.axes[a];
+        ImGui::PushID(a);
+        ImGui::Combo(a == 0 ? "X Parameter" : "Y Parameter", &axis.parameter, parameterNames.data(), parameterNames.size());
+        ImGui::InputFloat("Min", &axis.min, 0.0f, 0.0f, "%.4f");
+        ImGui::InputFloat("Max", &axis.max, 0.0f, 0.0f, "%.4f");
+        ImGui::PopID();
+    }
+
+    ImGui::InputInt("Initial Divisions", &m_sweepSettings.initialDivisions);
+    if(m_sweepSettings.initialDivisions < 1) m_sweepSettings.initialDivisions = 1;
+    ImGui::InputInt("Max Refinement Depth", &m_sweepSettings.maxDepth);
+    m_sweepSettings.maxDepth = std::clamp(m_sweepSettings.maxDepth, 0, 8);
+    ImGui::InputFloat("Refinement Tolerance", &m_sweepSettings.tolerance, 0.0f, 0.0f, "%.3f");
+
+    const bool sweeping = m_sweepFuture.valid() && m_sweepFuture.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+    if (ImGui::Button("Run Sweep") && !sweeping)
+    {
+        m_sweepFuture = std::async(std::launch::async, AdaptiveSampler::run, m_configuration, m_sweepSettings, std::ref(m_sweepProgress));
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Save Sweep") && !m_sweep.samples.empty())
+    {
+        Util::writeSweepToCsv(m_sweep, "sweep.csv");
+    }
+
+    if (sweeping)
+    {
+        ImGui::SameLine();
+        ImGui::ProgressBar(m_sweepProgress, ImVec2(0.0f, 0.0f));
+    }
+    else if (m_sweepFuture.valid())
+    {
+        m_sweep = m_sweepFuture.get();
+    }
+
+    if (m_sweep.samples.empty()) return;
+
+    ImGui::Text("%zu solves (%zu for the equivalent dense grid)", m_sweep.samples.size(), m_sweep.denseSolves);
+
+    const int count = m_sweep.samples.size();
+    const int stride = sizeof(SweepSample);
+    const SweepSample& first = m_sweep.samples.front();
+    const char* xLabel = parameterNames[m_sweep.settings.axes[0].parameter];
+
+    if (ImPlot::BeginPlot("Steady State Map"))
+    {
+        if (m_sweep.settings.dimensions == 1)
+        {
+            ImPlot::SetupAxes(xLabel, "Steady State", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+            ImPlot::PlotLine("Angular Velocity (rad/s)", &first.point[0], &first.state.angularVelocity, count, 0, 0, stride);
+            ImPlot::PlotLine("Drag (N)", &first.point[0], &first.state.drag, count, 0, 0, stride);
+            // Net torque is zero at every equilibrium, the aerodynamic torque is what the motor sees
+            ImPlot::PlotLine("Aerodynamic Torque (Nm)", &first.point[0], &first.state.aerodynamicTorque, count, 0, 0, stride);
+        }
+        else
+        {
+            // Sample locations show where the sweep refined
+            ImPlot::SetupAxes(xLabel, parameterNames[m_sweep.settings.axes[1].parameter], ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+            ImPlot::PlotScatter("Samples", &first.point[0], &first.point[1], count, 0, 0, stride);
+        }
+        ImPlot::EndPlot();
+    }
+}
+
+void App::renderSurrogate()
+{
+    if (!ImGui::CollapsingHeader("Surrogate Model")) return;
+
+    std::vector<const char*> parameterNames;
+    for (const SweepParameter& parameter : SweepParameters::All) parameterNames.push_back(parameter.name.c_str());
+
+    int dimensions = m_surrogateAxes.size();
+    if (ImGui::InputInt("Axes", &dimensions))
+    {
+        m_surrogateAxes.resize(std::clamp(dimensions, 1, Surrogate::MaxDimensions));
+    }
+
+    bool validAxes = true;
+    for (int a = 0; a < m_surrogateAxes.size(); ++a)
+    {
+        SurrogateAxis& axis = m_surrogateAxes[a];
+        ImGui::PushID(a);
+        ImGui::Combo("Parameter", &axis.parameter, parameterNames.data(), parameterNames.size());
+        ImGui::InputFloat("Min", &axis.min, 0.0f, 0.0f, "%.4f");
+        ImGui::InputFloat("Max", &axis.max, 0.0f, 0.0f, "%.4f");
+        ImGui::InputInt("Nodes", &axis.nodes);
+        if(axis.nodes < 2) axis.nodes = 2;
+        if (!axis.valid()) ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "Max must be greater than Min");
+        validAxes = validAxes && axis.valid();
+        ImGui::PopID();
+    }
+    ImGui::InputInt("Validation Solves", &m_surrogateValidationSamples);
+    if(m_surrogateValidationSamples < 0) m_surrogateValidationSamples = 0;
+
+    const bool training = m_surrogateFuture.valid() && m_surrogateFuture.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+    if (ImGui::Button("Train") && !training && validAxes)
+    {
+        m_surrogateFuture = std::async(std::launch::async, Surrogate::train, m_configuration, m_surrogateAxes, m_surrogateValidationSamples, std::ref(m_surrogateProgress));
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Save Model") && !m_surrogate.empty())
+    {
+        m_surrogate.save("surrogate.bin");
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Load Model") && !training)
+    {
+        if (m_surrogate.load("surrogate.bin")) m_surrogateAxes = m_surrogate.axes();
+    }
+
+    if (training)
+    {
+        ImGui::SameLine();
+        ImGui::ProgressBar(m_surrogateProgress, ImVec2(0.0f, 0.0f));
+    }
+    else if (m_surrogateFuture.valid())
+    {
+        m_surrogate = m_surrogateFuture.get();
+    }
+
+    if (m_surrogate.empty()) return;
+
+    if (!m_surrogate.trainedFor(m_configuration))
+    {
+        ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "Trained around another configuration, its predictions do not hold for the current one");
+    }
+    const SurrogateValidation& validation = m_surrogate.validation();
+    ImGui::Text("Validation against %zu held-out solves (RMS / max)", validation.samples);
+    ImGui::Text("Angular Velocity: %.4f / %.4f rad/s", validation.rmsError.angularVelocity, validation.maxError.angularVelocity);
+    ImGui::Text("Drag: %.3f / %.3f N", validation.rmsError.drag, validation.maxError.drag);
+    ImGui::Text("Side Force: %.3f / %.3f N", validation.rmsError.sideForce, validation.maxError.sideForce);
+}
+
+void App::renderConvergence()
+{
+    if (!ImGui::CollapsingHeader("Convergence Study")) return;
+
+    ImGui::InputInt("Levels", &m_convergenceSettings.levels);
+    m_convergenceSettings.levels = std::clamp(m_convergenceSettings.levels, 3, 6);
+    ImGui::InputFloat("Coarsest Time Step (s)", &m_convergenceSettings.coarsestTimeStep, 0.0f, 0.0f, "%.5f");
+    ImGui::InputFloat("Coarsest Radial Step (m)", &m_convergenceSettings.coarsestRadialStep, 0.0f, 0.0f, "%.4f");
+    ImGui::InputFloat("Relative Tolerance", &m_convergenceSettings.tolerance, 0.0f, 0.0f, "%.5f");
+
+    const bool studying = m_convergenceFuture.valid() && m_convergenceFuture.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+    if (ImGui::Button("Run Study") && !studying)
+    {
+        m_convergenceFuture = std::async(std::launch::async, Convergence::run, m_configuration, m_convergenceSettings, std::ref(m_convergenceProgress));
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Save Report") && !m_convergence.cases.empty())
+    {
+        Util::writeConvergenceStudyToCsv(m_convergence, "convergence.csv");
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Apply Recommended") && m_convergence.recommended >= 0)
+    {
+        const ConvergenceCase& recommended = m_convergence.cases[m_convergence.recommended];
+        m_configuration.timeStep = recommended.timeStep;
+        m_configuration.radialStep = recommended.radialStep;
+    }
+
+    if (studying)
+    {
+        ImGui::SameLine();
+        ImGui::ProgressBar(m_convergenceProgress, ImVec2(0.0f, 0.0f));
+    }
+    else if (m_convergenceFuture.valid())
+    {
+        m_convergence = m_convergenceFuture.get();
+    }
+
+    if (m_convergence.cases.empty()) return;
+
+    for (size_t o = 0; o < ConvergenceOutputCount; ++o)
+    {
+        ImGui::Text("%s: %.5g (observed order %.2f in time, %.2f in radius)", ConvergenceOutputNames[o],
+                    m_convergence.extrapolated[o], m_convergence.timeOrder[o], m_convergence.radialOrder[o]);
+    }
+
+    const ConvergenceCase& finest = m_convergence.cases.back();
+    if (m_convergence.recommended >= 0)
+    {
+        const ConvergenceCase& recommended = m_convergence.cases[m_convergence.recommended];
+        ImGui::Text("Recommended: time step %.5f s, radial step %.4f m, %.1fx cheaper than the finest pair",
+                    recommended.timeStep, recommended.radialStep, finest.cost / recommended.cost);
+    }
+    else
+    {
+        ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "No pair meets the tolerance, add levels or refine the coarsest steps");
+    }
+
+    // Worst relative error of each pair against its cost
+    std::vector<double> costs, errors;
+    for (const ConvergenceCase& convergenceCase : m_convergence.cases)
+    {
+        costs.push_back(convergenceCase.cost);
+        errors.push_back(std::max(*std::max_element(convergenceCase.errors.begin(), convergenceCase.errors.end()), 1e-9f));
+    }
+    const double toleranceX[] = {costs.front(), finest.cost};
+    const double toleranceY[] = {m_convergenceSettings.tolerance, m_convergenceSettings.tolerance};
+
+    if (ImPlot::BeginPlot("Cost vs Error"))
+    {
+        ImPlot::SetupAxes("Cost (section evaluations)", "Max Relative Error", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+        ImPlot::SetupAxisScale(ImAxis_X1, ImPlotScale_Log10);
+        ImPlot::SetupAxisScale(ImAxis_Y1, ImPlotScale_Log10);
+        ImPlot::PlotScatter("Pairs", costs.data(), errors.data(), costs.size());
+        ImPlot::PlotLine("Tolerance", toleranceX, toleranceY, 2);
+        if (m_convergence.recommended >= 0)
+        {
+            ImPlot::PlotScatter("Recommended", &costs[m_convergence.recommended], &errors[m_convergence.recommended], 1);
+        }
+        ImPlot::EndPlot();
+    }
+}
+
+void App::renderSpectrum()
+{
+    if (!ImGui::CollapsingHeader("Load Spectrum")) return;
+    if (m_selectedSolution == -1) return;
+
+    const Solution* solution = m_solutions.get(m_selectedSolution);
+    if (!solution) return;
+    const SpectralAnalysis& spectrum = solution->spectrum;
+
+    ImGui::Combo("Signal", &m_spectralSignal, SpectralSignalNames.data(), static_cast<int>(SpectralSignalCount));
+    const size_t signal = static_cast<size_t>(m_spectralSignal);
+
+    if (spectrum.segments == 0)
+    {
+        ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "Too few time steps in the analysed tail for a spectrum");
+    }
+    else
+    {
+        // Rotor and blade passing frequencies at the steady angular velocity
+        const float rotorFrequency = std::abs(solution->steadyState().angularVelocity) / (2.0f * Util::PI);
+        const float bladePassingFrequency = rotorFrequency * solution->configuration.numBlades;
+        ImGui::Text("Welch: %zu segments of %d steps, %.3f Hz resolution. Rotor %.2f Hz, blade passing %.2f Hz",
+                    spectrum.segments, spectrum.settings.segmentLength, spectrum.frequency[1], rotorFrequency, bladePassingFrequency);
+
+        const std::vector<float>& psd = spectrum.psd[signal];
+        const auto [minimum, maximum] = std::minmax_element(psd.begin() + 1, psd.end());
+        const float markerY[] = {std::max(*minimum, 1e-12f), std::max(*maximum, 1e-12f)};
+        const float rotorX[] = {rotorFrequency, rotorFrequency};
+        const float bladePassingX[] = {bladePassingFrequency, bladePassingFrequency};
+
+        if (ImPlot::BeginPlot("Power Spectral Density"))
+        {
+            // DC is removed per segment, start at the first bin so the log axis stays readable
+            ImPlot::SetupAxes("Frequency (Hz)", "PSD (units^2/Hz)", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+            ImPlot::SetupAxisScale(ImAxis_Y1, ImPlotScale_Log10);
+            ImPlot::PlotLine(SpectralSignalNames[signal], spectrum.frequency.data() + 1, psd.data() + 1, static_cast<int>(psd.size() - 1));
+            ImPlot::PlotLine("1x Rotor", rotorX, markerY, 2);
+            ImPlot::PlotLine("Blade Passing", bladePassingX, markerY, 2);
+            ImPlot::EndPlot();
+        }
+    }
+
+    if (spectrum.revolutionTime.empty()) return;
+
+    if (ImPlot::BeginPlot("Rotor Harmonics"))
+    {
+        const int count = static_cast<int>(spectrum.revolutionTime.size());
+        ImPlot::SetupAxes("Time (s)", "Amplitude", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+        ImPlot::PlotLine("1x Rotor", spectrum.revolutionTime.data(), spectrum.rotorHarmonic[signal].data(), count);
+        ImPlot::PlotLine("Blade Passing", spectrum.revolutionTime.data(), spectrum.bladePassingHarmonic[signal].data(), count);
+        ImPlot::EndPlot();
+    }
+}
+
+void App::renderSteadySolver()
+{
+    if (!ImGui::CollapsingHeader("Steady State Solver")) return;
+
+    ImGui::InputFloat("Max Tip Speed Ratio", &m_steadySettings.maxTipSpeedRatio);
+    ImGui::InputInt("Scan Intervals", &m_steadySettings.scanIntervals);
+    ImGui::InputInt("Cycle Samples", &m_steadySettings.cycleSamples);
+    m_steadySettings.maxTipSpeedRatio = std::max(m_steadySettings.maxTipSpeedRatio, 0.1f);
+    m_steadySettings.scanIntervals = std::clamp(m_steadySettings.scanIntervals, 2, 1000);
+    m_steadySettings.cycleSamples = std::clamp(m_steadySettings.cycleSamples, 1, 256);
+
+    if (ImGui::Button("Find Equilibria"))
+    {
+        m_steady = SteadySolver::solve(m_configuration, m_steadySettings);
+    }
+    if (m_steady.scanVelocity.empty()) return;
+
+    ImGui::SameLine();
+    ImGui::Text("%zu blade evaluations", m_steady.evaluations);
+    if (m_steady.equilibria.empty())
+    {
+        ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "No equilibrium in the scanned range, raise the tip speed ratio");
+    }
+
+    for (size_t i = 0; i < m_steady.equilibria.size(); ++i)
+    {
+        const SteadyOperatingPoint& point = m_steady.equilibria[i];
+        ImGui::PushID(static_cast<int>(i));
+        ImGui::Text("%s: %.3f rad/s, drag %.2f N, side force %.2f N, dT/dw %.4g Nms", point.stable ? "Stable" : "Unstable",
+                    point.state.angularVelocity, point.state.drag, point.state.sideForce, point.torqueSlope);
+        ImGui::SameLine();
+        if (ImGui::SmallButton("Start Here"))
+        {
+            m_configuration.initialAngularVelocity = point.state.angularVelocity;
+        }
+        ImGui::PopID();
+    }
+
+    if (ImPlot::BeginPlot("Net Torque vs Angular Velocity"))
+    {
+        ImPlot::SetupAxes("Angular Velocity (rad/s)", "Cycle Averaged Net Torque (Nm)", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+        ImPlot::PlotLine("Net Torque", m_steady.scanVelocity.data(), m_steady.scanTorque.data(), static_cast<int>(m_steady.scanVelocity.size()));
+
+        std::vector<float> velocities, torques;
+        for (const SteadyOperatingPoint& point : m_steady.equilibria)
+        {
+            velocities.push_back(point.state.angularVelocity);
+            torques.push_back(point.state.torque);
+        }
+        ImPlot::PlotScatter("Equilibria", velocities.data(), torques.data(), static_cast<int>(velocities.size()));
+        ImPlot::EndPlot();
+    }
+}
+
+void App::renderParareal()
+{
+    if (!ImGui::CollapsingHeader("Parareal")) return;
+
+    ImGui::InputInt("Time Slices", &m_pararealSettings.slices);
+    m_pararealSettings.slices = std::clamp(m_pararealSettings.slices, 1, 4096);
+    int coarse = static_cast<int>(m_pararealSettings.coarse);
+    ImGui::RadioButton("Large Step", &coarse, static_cast<int>(PararealCoarse::LargeStep));
+    ImGui::SameLine();
+    ImGui::RadioButton("Cycle Averaged", &coarse, static_cast<int>(PararealCoarse::CycleAveraged));
+    m_pararealSettings.coarse = static_cast<PararealCoarse>(coarse);
+    if (m_pararealSettings.coarse == PararealCoarse::LargeStep)
+    {
+        ImGui::InputInt("Fine Steps per Coarse Step", &m_pararealSettings.coarseRatio);
+        m_pararealSettings.coarseRatio = std::max(m_pararealSettings.coarseRatio, 1);
+    }
+    else
+    {
+        ImGui::InputInt("Coarse Steps per Slice", &m_pararealSettings.coarseSteps);
+        m_pararealSettings.coarseSteps = std::max(m_pararealSettings.coarseSteps, 1);
+        ImGui::InputInt("Cycle Samples", &m_pararealSettings.cycleSamples);
+        m_pararealSettings.cycleSamples = std::clamp(m_pararealSettings.cycleSamples, 1, 256);
+    }
+    ImGui::InputFloat("Relative Tolerance##Parareal", &m_pararealSettings.tolerance, 0.0f, 0.0f, "%.6f");
+    ImGui::Checkbox("Compare With Serial Solve", &m_pararealSettings.compareSerial);
+
+    const bool running = m_pararealFuture.valid() && m_pararealFuture.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+    if (ImGui::Button("Run Parareal") && !running)
+    {
+        m_pararealFuture = std::async(std::launch::async, Parareal::solve, m_configuration, m_pararealSettings, std::ref(m_pararealProgress));
+    }
+
+    if (running)
+    {
+        ImGui::SameLine();
+        ImGui::ProgressBar(m_pararealProgress, ImVec2(0.0f, 0.0f));
+    }
+    else if (m_pararealFuture.valid())
+    {
+        m_parareal = m_pararealFuture.get();
+        m_solutions.add(std::move(m_parareal.solution));
+        m_selectedSolution = m_solutions.size() - 1;
+        m_configuration = m_solutions.configuration(m_selectedSolution);
+        m_fitPlots = true;
+    }
+
+    if (m_parareal.iterations == 0) return;
+
+    if (!m_parareal.converged)
+    {
+        ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "Not converged, the solution is only as good as the last sweep");
+    }
+    ImGui::Text("%d iterations, %zu fine steps", m_parareal.iterations, m_parareal.fineSteps);
+    ImGui::Text("Critical path speedup %.2fx with a core per slice", m_parareal.criticalPathSpeedup);
+    if (m_parareal.serialSeconds > 0)
+    {
+        ImGui::Text("%.3f s against %.3f s serial, %.2fx measured", m_parareal.seconds, m_parareal.serialSeconds, m_parareal.speedup);
+        ImGui::Text("Largest angular velocity deviation %.3g rad/s", m_parareal.maxDeviation);
+    }
+    else
+    {
+        ImGui::Text("%.3f s", m_parareal.seconds);
+    }
+}
+
+void App::renderMultiRotor()
+{
+    if (!ImGui::CollapsingHeader("Multi-Rotor Aircraft")) return;
+
+    ImGui::Text("Vertical rotor axes at (x, y), x along the freestream. Time and flight conditions are shared.");
+    if (ImGui::Button("Add Current Rotor"))
+    {
+        m_aircraft.rotors.push_back({"rotor_" + std::to_string(m_aircraft.rotors.size()), m_configuration, 0.0f, 0.0f, 0.0f});
+    }
+
+    for (size_t r = 0; r < m_aircraft.rotors.size(); ++r)
+    {
+        RotorPlacement& rotor = m_aircraft.rotors[r];
+        ImGui::PushID(static_cast<int>(r));
+        ImGui::Text("%s", rotor.name.c_str());
+        ImGui::SameLine(100);
+        ImGui::SetNextItemWidth(70);
+        ImGui::InputFloat("x (m)", &rotor.x, 0.0f, 0.0f, "%.3f");
+        ImGui::SameLine();
+        ImGui::SetNextItemWidth(70);
+        ImGui::InputFloat("y (m)", &rotor.y, 0.0f, 0.0f, "%.3f");
+        ImGui::SameLine();
+        ImGui::SetNextItemWidth(70);
+        ImGui::InputFloat("Phase (rads)", &rotor.phase, 0.0f, 0.0f, "%.3f");
+        ImGui::SameLine();
+        if (ImGui::SmallButton("Use Current")) rotor.configuration = m_configuration;
+        ImGui::SameLine();
+        if (ImGui::SmallButton("Edit")) m_configuration = rotor.configuration;
+        ImGui::SameLine();
+        const bool remove = ImGui::SmallButton("Remove");
+        ImGui::PopID();
+        if (remove)
+        {
+            m_aircraft.rotors.erase(m_aircraft.rotors.begin() + r);
+            break;
+        }
+    }
+
+    const bool solving = m_aircraftFuture.valid() && m_aircraftFuture.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+    if (ImGui::Button("Solve Aircraft") && !solving && !m_aircraft.rotors.empty())
+    {
+        m_aircraft.flight = m_configuration;
+        if (m_parallelSections && !m_aircraftTeam) m_aircraftTeam = std::make_unique<WorkerTeam>();
+        m_aircraftFuture = std::async(std::launch::async, MultiRotor::solve, m_aircraft, std::ref(m_aircraftProgress),
+                                      m_parallelSections ? m_aircraftTeam.get() : nullptr);
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Save Aircraft") && !m_aircraftSolution.time.empty())
+    {
+        Util::writeMultiRotorSolutionToCsv(m_aircraftSolution, "aircraft.csv");
+    }
+
+    if (solving)
+    {
+        ImGui::SameLine();
+        ImGui::ProgressBar(m_aircraftProgress, ImVec2(0.0f, 0.0f));
+    }
+    else if (m_aircraftFuture.valid())
+    {
+        m_aircraftSolution = m_aircraftFuture.get();
+    }
+
+    if (m_aircraftSolution.rotors.empty()) return;
+
+    const MultiRotorSteadyState steady = m_aircraftSolution.steadyState();
+    for (size_t r = 0; r < steady.rotors.size(); ++r)
+    {
+        const AircraftLoads& loads = steady.rotors[r];
+        ImGui::Text("%s: drag %.2f N, side force %.2f N, yaw moment %.2f Nm", m_aircraftSolution.rotors[r].name.c_str(), loads.drag, loads.sideForce, loads.yawMoment);
+    }
+    ImGui::Text("Total: drag %.2f N, side force %.2f N, yaw moment %.2f Nm", steady.total.drag, steady.total.sideForce, steady.total.yawMoment);
+
+    const char* totalNames[] = { "Drag (N)", "Side Force (N)", "Yaw Moment (Nm)" };
+    ImGui::Combo("Aircraft Total", &m_aircraftTotal, totalNames, IM_ARRAYSIZE(totalNames));
+    if (ImPlot::BeginPlot("Aircraft Totals"))
+    {
+        const MultiRotorSolution::Total total = static_cast<MultiRotorSolution::Total>(m_aircraftTotal);
+        ImPlot::SetupAxes("Time (s)", totalNames[m_aircraftTotal], ImPlotAxisFlags_None, ImPlotAxisFlags_AutoFit);
+        ImPlot::SetupAxisLimits(ImAxis_X1, m_aircraftSolution.time.front(), m_aircraftSolution.time.back(), ImPlotCond_Once);
+        const ImPlotRect limits = ImPlot::GetPlotLimits();
+        const MinMaxPyramid::View view = m_aircraftSolution.view(total, limits.X.Min, limits.X.Max, ImPlot::GetPlotSize().x);
+        ImPlot::PlotLine(totalNames[m_aircraftTotal], view.x, view.y, view.count);
+        ImPlot::EndPlot();
+    }
+}
+
+void App::renderPolarImport()
+{
+    if (!ImGui::CollapsingHeader("Fluent Polars")) return;
+
+    ImGui::InputText("Fluent Project Files", m_polarDirectory, sizeof(m_polarDirectory));
+
+    const bool importing = m_polarFuture.valid() && m_polarFuture.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+    if (ImGui::Button("Import") && !importing)
+    {
+        PolarImportSettings settings;
+        settings.directory = m_polarDirectory;
+        m_polarFuture = std::async(std::launch::async, PolarImport::run, settings, std::ref(m_polarProgress));
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Load Polars"))
+    {
+        if (std::shared_ptr<const PolarSet> polars = PolarImport::load("polars.csv"))
+        {
+            m_polarImport = PolarImportResult();
+            m_polarImport.polars = polars;
+        }
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Save Polars") && m_polarImport.polars)
+    {
+        PolarImport::save(*m_polarImport.polars, "polars.csv");
+    }
+
+    if (importing)
+    {
+        ImGui::SameLine();
+        ImGui::ProgressBar(m_polarProgress, ImVec2(0.0f, 0.0f));
+    }
+    else if (m_polarFuture.valid())
+    {
+        m_polarImport = m_polarFuture.get();
+    }
+
+    ImGui::Text("Solving with %s polars", m_configuration.polars ? "imported" : "built-in");
+    if (ImGui::Button("Use Imported") && m_polarImport.polars) m_configuration.polars = m_polarImport.polars;
+    ImGui::SameLine();
+    if (ImGui::Button("Use Built-In")) m_configuration.polars.reset();
+
+    if (!m_polarImport.polars) return;
+
+    if (!m_polarImport.points.empty())
+    {
+        ImGui::Text("%zu design points, %zu from report files and %zu from the design point log, %.3f s",
+                    m_polarImport.points.size(), m_polarImport.fromReports, m_polarImport.fromLog, m_polarImport.seconds);
+    }
+    for (const std::string& warning : m_polarImport.warnings)
+    {
+        ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "%s", warning.c_str());
+    }
+
+    if (ImPlot::BeginPlot("Polars"))
+    {
+        ImPlot::SetupAxes("Angle of Attack (rads)", "Coefficient", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+        const std::array<std::pair<const char*, const AeroCoefficientInterpolator*>, 4> polars = {{
+            {"Lift", &m_polarImport.polars->lift}, {"Drag", &m_polarImport.polars->drag},
+            {"Reverse Lift", &m_polarImport.polars->reverseLift}, {"Reverse Drag", &m_polarImport.polars->reverseDrag}
+        }};
+        std::vector<float> alphas, coefficients;
+        for (const auto& [name, polar] : polars)
+        {
+            for (const auto& [reynolds, points] : polar->coefficients())
+            {
+                alphas.clear();
+                coefficients.clear();
+                for (const auto& [alpha, coefficient] : points)
+                {
+                    alphas.push_back(alpha);
+                    coefficients.push_back(coefficient);
+                }
+                const std::string label = std::string(name) + " Re " + std::to_string(static_cast<int>(reynolds));
+                ImPlot::PlotLine(label.c_str(), alphas.data(), coefficients.data(), static_cast<int>(alphas.size()));
+            }
+        }
+        ImPlot::EndPlot();
+    }
+}
+
+void App::renderCycles()
+{
+    if (!ImGui::CollapsingHeader("Revolution Statistics")) return;
+    if (m_selectedSolution == -1) return;
+
+    const Solution* solution = m_solutions.get(m_selectedSolution);
+    if (!solution) return;
+    const CycleStatistics& cycles = solution->cycles;
+    if (cycles.size() == 0)
+    {
+        ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "No completed revolutions");
+        return;
+    }
+
+    ImGui::Combo("Load", &m_cycleSignal, CycleSignalNames.data(), static_cast<int>(CycleSignalCount));
+    const size_t signal = static_cast<size_t>(m_cycleSignal);
+    const size_t last = cycles.size() - 1;
+    ImGui::Text("%zu revolutions. Last: %.3f s at %.2f rad/s, mean %.3f, RMS %.3f, peak-to-peak %.3f", cycles.size(), cycles.period[last],
+                cycles.angularVelocity[last], cycles.mean[signal][last], cycles.rms[signal][last], cycles.peakToPeak[signal][last]);
+
+    std::vector<float> revolutions(cycles.size());
+    for (size_t r = 0; r < revolutions.size(); ++r) revolutions[r] = static_cast<float>(r + 1);
+    const int count = static_cast<int>(revolutions.size());
+
+    if (ImPlot::BeginPlot("Load per Revolution"))
+    {
+        ImPlot::SetupAxes("Revolution", CycleSignalNames[signal], ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+        ImPlot::PlotLine("Mean", revolutions.data(), cycles.mean[signal].data(), count);
+        ImPlot::PlotLine("RMS", revolutions.data(), cycles.rms[signal].data(), count);
+        ImPlot::PlotLine("Peak-to-Peak", revolutions.data(), cycles.peakToPeak[signal].data(), count);
+        ImPlot::EndPlot();
+    }
+
+    if (ImPlot::BeginPlot("Angular Velocity per Revolution"))
+    {
+        ImPlot::SetupAxes("Revolution", "Angular Velocity (rad/s)", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+        ImPlot::PlotLine("Mean", revolutions.data(), cycles.angularVelocity.data(), count);
+        ImPlot::EndPlot();
+    }
 }
\ No newline at end of file
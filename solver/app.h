@@ -2,12 +2,29 @@
 #define _APP_H_
 
 #include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <future>
+#include <memory>
+#include <optional>
 
+#include "adaptive_sampler.h"
 #include "configuration.h"
+#include "convergence.h"
 #include "implot.h"
+#include "multi_rotor.h"
+#include "overlay_cache.h"
+#include "parareal.h"
 #include "plot_configuration.h"
+#include "polar_import.h"
+#include "ring_buffer.h"
+#include "sectional_loads.h"
+#include "solution_store.h"
+#include "solver.h"
+#include "steady_solver.h"
+#include "surrogate.h"
 #include "window.h"
+#include "worker_team.h"
 
 class App : public Window
 {
@@ -17,26 +34,137 @@ class App : public Window
 
     private:
         void update() final;
+        bool isBusy() const final;
         void renderPlots();
+        bool isSolving() const;
+        void drainStream();
+
+        // Runs the solve state machine: collects the finished job, then starts the pending one once it is due
+        void requestSolve(bool preview, float delay);
+        void updateSolve();
+        void startSolve(bool preview);
+        void renderSweep();
+        void renderSurrogate();
+        void renderConvergence();
+        void renderSpectrum();
+        void renderCycles();
+        void renderSteadySolver();
+        void renderParareal();
+        void renderMultiRotor();
+        void renderPolarImport();
     
     private:
         Configuration m_configuration = Configuration();
-        std::vector<Solution> m_solutions;
+        SolutionStore m_solutions;
         std::future<Solution> m_future;
         std::atomic<float> m_progress = 0;
 
+        // Auto-solve: an edit starts a reduced fidelity preview after a short pause, and the full solve once edits stop.
+        // Whatever is still running for an outdated configuration is cancelled first.
+        static constexpr float PreviewDelay = 0.15f;
+        static constexpr float FullSolveDelay = 1.0f;
+        bool m_autoSolve = false;
+        PreviewFidelity m_previewFidelity;
+        Configuration m_editedConfiguration;
+        std::chrono::steady_clock::time_point m_lastEdit;
+
+        // The running job and the generation it was started in, and the one waiting for it (true for a preview).
+        // Every request bumps the generation, a finished job is only kept if nothing was requested since it started.
+        // A full solve selects its result unless the user selected another solution meanwhile.
+        bool m_solvingPreview = false;
+        uint64_t m_solveGeneration = 0, m_jobGeneration = 0;
+        bool m_selectResult = false;
+        std::optional<bool> m_pendingPreview;
+        std::chrono::steady_clock::time_point m_pendingStart;
+        std::atomic<bool> m_cancel = false;
+
+        // Latest preview, plotted until a full solve or another selection replaces it
+        Solution m_preview;
+        bool m_showPreview = false;
+
+        // Decimated samples published by the solver thread while a solve is running
+        RingBuffer<SolutionSample> m_stream = RingBuffer<SolutionSample>(4096);
+        Solution m_liveSolution;
+
+        // Opt-in sectional load capture, the writer lives until the next solve replaces it
+        bool m_captureSectionalLoads = false;
+        SectionalCaptureSettings m_captureSettings;
+        std::unique_ptr<SectionalLoadWriter> m_capture;
+
+        // Splits the blade sections of each step across cores on fine radial steps, created on first use
+        bool m_parallelSections = true;
+        std::unique_ptr<WorkerTeam> m_team;
+
         int m_selectedSolution = -1;
 
+        // Overlay of many solutions on the same axes, drawn from resampled buffers cached per solution
+        bool m_overlay = false;
+        std::vector<bool> m_overlaid;
+        OverlayCache m_overlayCache;
+
+        // Adaptive parameter sweep
+        AdaptiveSweepSettings m_sweepSettings;
+        std::future<SweepResult> m_sweepFuture;
+        std::atomic<float> m_sweepProgress = 0;
+        SweepResult m_sweep;
+
+        // Surrogate steady state model
+        std::vector<SurrogateAxis> m_surrogateAxes = {{0, 40, 120, 9}, {1, -0.3f, 0.3f, 7}};
+        int m_surrogateValidationSamples = 16;
+        std::future<Surrogate> m_surrogateFuture;
+        std::atomic<float> m_surrogateProgress = 0;
+        Surrogate m_surrogate;
+
+        // Discretization convergence study
+        ConvergenceSettings m_convergenceSettings;
+        std::future<ConvergenceStudy> m_convergenceFuture;
+        std::atomic<float> m_convergenceProgress = 0;
+        ConvergenceStudy m_convergence;
+
+        // Direct steady state solve, fast enough to run on the UI thread
+        SteadySolverSettings m_steadySettings;
+        SteadySolution m_steady;
+
+        // Parallel-in-time solve, its solution joins the others once it finishes
+        PararealSettings m_pararealSettings;
+        std::future<PararealResult> m_pararealFuture;
+        std::atomic<float> m_pararealProgress = 0;
+        PararealResult m_parareal;
+
+        // Multi-rotor aircraft, rotors are added from the current configuration. Its solves get their own team,
+        // they can run alongside a single rotor solve.
+        MultiRotorConfiguration m_aircraft;
+        std::future<MultiRotorSolution> m_aircraftFuture;
+        std::atomic<float> m_aircraftProgress = 0;
+        MultiRotorSolution m_aircraftSolution;
+        std::unique_ptr<WorkerTeam> m_aircraftTeam;
+        int m_aircraftTotal = static_cast<int>(MultiRotorSolution::Total::Drag);
+
+        // Airfoil polars imported from the Fluent design points, solves use them once applied to the configuration
+        char m_polarDirectory[256] = "ansys-fluent-analysis/airfoil_model_files";
+        std::future<PolarImportResult> m_polarFuture;
+        std::atomic<float> m_polarProgress = 0;
+        PolarImportResult m_polarImport;
+
+        // Load spectrum of the selected solution
+        int m_spectralSignal = static_cast<int>(SpectralSignal::SideForce);
+
+        // Revolution statistics of the selected solution
+        int m_cycleSignal = static_cast<int>(CycleSignal::Drag);
+
+        // Refit the time axis of every plot on the next frame (new or reselected solution)
+        bool m_fitPlots = true;
+
         const std::array<PlotConfiguration, 3> m_PlotConfigsColumn1 = {{
-            {"Angular Velocity", "Time (s)", "Angular Velocity (rad/s)", &Solution::getAngularVelocity},
-            {"Lift", "Time (s)", "Lift (N)", &Solution::getLift},
-            {"Torque", "Time (s)", "Torque (Nm)", &Solution::getTorque}
+            {"Angular Velocity", "Time (s)", "Angular Velocity (rad/s)", Solution::Field::AngularVelocity},
+            {"Lift", "Time (s)", "Lift (N)", Solution::Field::Lift},
+            {"Torque", "Time (s)", "Torque (Nm)", Solution::Field::Torque}
         }};
 
         const std::array<PlotConfiguration, 3> m_PlotConfigsColumn2 = {{
-            {"Angular Acceleration", "Time (s)", "Angular Acceleration (rad/s^2)", &Solution::getAngularAcceleration},    
-            {"Drag", "Time (s)", "Drag (N)", &Solution::getDrag},
-            {"Side Force", "Time (s)", "Side Force (N)", &Solution::getSideForce}
+            {"Angular Acceleration", "Time (s)", "Angular Acceleration (rad/s^2)", Solution::Field::AngularAcceleration},    
+            {"Drag", "Time (s)", "Drag (N)", Solution::Field::Drag},
+            {"Side Force", "Time (s)", "Side Force (N)", Solution::Field::SideForce}
         }};
 
         template<size_t N>
@@ -46,12 +174,41 @@ class App : public Window
             {
                 if (ImPlot::BeginPlot(plotConfig.title.c_str()))
                 {
-                    ImPlot::SetupAxes(plotConfig.xLabel.c_str(), plotConfig.yLabel.c_str(), ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
-                    if(m_selectedSolution != -1)
+                    if(isSolving() && !m_solvingPreview)
+                    {
+                        // The live stream is already decimated, grow the axes with it
+                        ImPlot::SetupAxes(plotConfig.xLabel.c_str(), plotConfig.yLabel.c_str(), ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+                        if(m_liveSolution.time.size() > 1)
+                        {
+                            ImPlot::SetNextLineStyle(m_liveSolution.color, 2.0f);
+                            ImPlot::PlotLine(m_liveSolution.name.c_str(), m_liveSolution.time.data(), m_liveSolution.field(plotConfig.field).data(), m_liveSolution.time.size());
+                        }
+                    }
+                    else if(m_overlay && !m_overlayCache.curves().empty())
+                    {
+                        const std::vector<float>& time = m_overlayCache.time();
+                        ImPlot::SetupAxes(plotConfig.xLabel.c_str(), plotConfig.yLabel.c_str(), ImPlotAxisFlags_None, ImPlotAxisFlags_AutoFit);
+                        ImPlot::SetupAxisLimits(ImAxis_X1, time.front(), time.back(), m_fitPlots ? ImPlotCond_Always : ImPlotCond_Once);
+                        for(const OverlayCache::Curve& curve : m_overlayCache.curves())
+                        {
+                            ImPlot::SetNextLineStyle(curve.color, 1.0f);
+                            ImPlot::PlotLine(curve.name.c_str(), time.data(), curve.fields[static_cast<size_t>(plotConfig.field)].data(), curve.count);
+                        }
+                    }
+                    else
                     {
-                        const Solution& solution = m_solutions[m_selectedSolution];
-                        ImPlot::SetNextLineStyle(solution.color, 2.0f);
-                        ImPlot::PlotLine(solution.name.c_str(), solution.time.data(), plotConfig.field(solution).data(), solution.time.size() - 1); 
+                        // Time is zoomable, only the level of detail matching the visible range and plot width is drawn
+                        ImPlot::SetupAxes(plotConfig.xLabel.c_str(), plotConfig.yLabel.c_str(), ImPlotAxisFlags_None, ImPlotAxisFlags_AutoFit);
+                        // Nothing to draw for an entry the store could not reload
+                        const Solution* solution = m_showPreview ? &m_preview : m_selectedSolution != -1 ? m_solutions.get(m_selectedSolution) : nullptr;
+                        if(solution && !solution->time.empty())
+                        {
+                            ImPlot::SetupAxisLimits(ImAxis_X1, solution->time.front(), solution->time.back(), m_fitPlots ? ImPlotCond_Always : ImPlotCond_Once);
+                            const ImPlotRect limits = ImPlot::GetPlotLimits();
+                            const MinMaxPyramid::View view = solution->view(plotConfig.field, limits.X.Min, limits.X.Max, ImPlot::GetPlotSize().x);
+                            ImPlot::SetNextLineStyle(solution->color, 2.0f);
+                            ImPlot::PlotLine(solution->name.c_str(), view.x, view.y, view.count);
+                        }
                     }
                     ImPlot::EndPlot();
                 }
@@ -4,6 +4,9 @@
 #include "aero_coefficient_interpolator.h"
 
 #include <array>
+#include <cstdint>
+#include <cstring>
+#include <memory>
 
 #include "util.h"
 #include "vec3.h"
@@ -13,12 +16,27 @@ enum class Airfoil
     DAE_51 = 0
 };
 
+// How blade sections are placed along [hubRadius, propellerRadius] and weighted in the blade integral
+enum class RadialQuadrature
+{
+    Midpoint = 0,
+    GaussLegendre,
+    TipCosine
+};
+
+// Polars loaded at run time (see PolarImport), in place of the built-in tables of the blade airfoil
+struct PolarSet
+{
+    AeroCoefficientInterpolator lift, drag, reverseLift, reverseDrag;
+};
+
 struct Configuration
 {
     // Simulation Parameters
     float simTime = 10;
     float timeStep = 0.001;
     float radialStep = 0.01;
+    RadialQuadrature radialQuadrature = RadialQuadrature::Midpoint;
 
     // Flight Conditions
     Vec3 freestreamVelocity = {87, 0, 0};
@@ -45,6 +63,13 @@ struct Configuration
     std::array<float, 11> bladePitch = { 0.9756390519f, 0.9756390519f, 0.9756390519f, 0.8534660042f, 0.7382742736f, 0.6492624817f, 0.5724679947f, 0.5235987756f, 0.4607669225f, 0.4241150082f, 0.3926990817f };
 
     Airfoil bladeAirfoil = Airfoil::DAE_51;
+    std::shared_ptr<const PolarSet> polars;
+
+    // Tells edits apart. Floats compare by their bits, so a NaN field equals itself instead of reading as a new edit
+    // every frame, and imported polars compare by their tables, not by pointer. New fields must be added here and to
+    // hash(), which is consistent with it and stable across runs, so it can be stored in files.
+    bool operator==(const Configuration& other) const;
+    uint64_t hash() const;
 
     float bladeChordAt(const float& r) const
     {
@@ -74,30 +99,134 @@ struct Configuration
         return bladePitch[i] * (1.0f - frac) + bladePitch[i + 1] * frac;
     }
 
-    // Should differentiate between airfoils (for now assume DAE-51)
+    // Braking torque of the shorted motor per unit angular velocity, 1 / (Kv^2 R)
+    float motorDamping() const { return 1.0f / (motorVelocityConstant * motorVelocityConstant * motorResistance); }
+
+    // Should differentiate between airfoils (for now assume DAE-51), imported polars take precedence
+    const AeroCoefficientInterpolator& liftPolar() const { return polars ? polars->lift : AeroCoefficientInterpolator::Dae51Lift; }
+    const AeroCoefficientInterpolator& dragPolar() const { return polars ? polars->drag : AeroCoefficientInterpolator::Dae51Drag; }
+    const AeroCoefficientInterpolator& reverseLiftPolar() const { return polars ? polars->reverseLift : AeroCoefficientInterpolator::Dae51LiftReversed; }
+    const AeroCoefficientInterpolator& reverseDragPolar() const { return polars ? polars->reverseDrag : AeroCoefficientInterpolator::Dae51DragReversed; }
+
     float dragCoefficientAt(const float& r, const float& reynolds) const
     {
         //return 0.005; // ~ Re = 300,000 + 5deg AOA 0.005
-        return AeroCoefficientInterpolator::Dae51Drag.coefficientAt(bladePitchAt(r), reynolds);
+        return dragPolar().coefficientAt(bladePitchAt(r), reynolds);
     }
 
     float liftCoefficientAt(const float& r, const float& reynolds) const
     {
         //return 0.75; // Usually at 5deg AOA
-        return AeroCoefficientInterpolator::Dae51Lift.coefficientAt(bladePitchAt(r), reynolds);
+        return liftPolar().coefficientAt(bladePitchAt(r), reynolds);
     }
 
     float reverseDragCoefficientAt(const float& r, const float& reynolds) const
     {
         //return 0.03;
-        return AeroCoefficientInterpolator::Dae51DragReversed.coefficientAt(bladePitchAt(r), reynolds);
+        return reverseDragPolar().coefficientAt(bladePitchAt(r), reynolds);
     }
 
     float reverseLiftCoefficientAt(const float& r, const float& reynolds) const
     {
-        return AeroCoefficientInterpolator::Dae51LiftReversed.coefficientAt(bladePitchAt(r), reynolds);
+        return reverseLiftPolar().coefficientAt(bladePitchAt(r), reynolds);
         //return 0.3;
     }
 };
 
+namespace ConfigurationDetail
+{
+    template<typename T>
+    bool sameBits(const T& a, const T& b)
+    {
+        return std::memcmp(&a, &b, sizeof(T)) == 0;
+    }
+
+    inline bool samePolar(const AeroCoefficientInterpolator& a, const AeroCoefficientInterpolator& b)
+    {
+        const auto& first = a.coefficients();
+        const auto& second = b.coefficients();
+        if (first.size() != second.size()) return false;
+        for (auto i = first.begin(), j = second.begin(); i != first.end(); ++i, ++j)
+        {
+            if (!sameBits(i->first, j->first) || i->second.size() != j->second.size()) return false;
+            if (!i->second.empty() && std::memcmp(i->second.data(), j->second.data(), i->second.size() * sizeof(i->second[0])) != 0) return false;
+        }
+        return true;
+    }
+
+    // FNV-1a
+    inline void hashBytes(uint64_t& hash, const void* data, size_t size)
+    {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= 0x100000001b3ull;
+        }
+    }
+
+    template<typename T>
+    void hashValue(uint64_t& hash, const T& value)
+    {
+        hashBytes(hash, &value, sizeof(T));
+    }
+
+    inline void hashPolar(uint64_t& hash, const AeroCoefficientInterpolator& polar)
+    {
+        hashValue(hash, static_cast<uint64_t>(polar.coefficients().size()));
+        for (const auto& [reynolds, table] : polar.coefficients())
+        {
+            hashValue(hash, reynolds);
+            hashValue(hash, static_cast<uint64_t>(table.size()));
+            if (!table.empty()) hashBytes(hash, table.data(), table.size() * sizeof(table[0]));
+        }
+    }
+}
+
+inline bool Configuration::operator==(const Configuration& other) const
+{
+    using ConfigurationDetail::sameBits;
+    using ConfigurationDetail::samePolar;
+
+    const bool samePolars = polars == other.polars ||
+        (polars && other.polars && samePolar(polars->lift, other.polars->lift) && samePolar(polars->drag, other.polars->drag) &&
+         samePolar(polars->reverseLift, other.polars->reverseLift) && samePolar(polars->reverseDrag, other.polars->reverseDrag));
+
+    return sameBits(simTime, other.simTime) && sameBits(timeStep, other.timeStep) && sameBits(radialStep, other.radialStep) &&
+           radialQuadrature == other.radialQuadrature &&
+           sameBits(freestreamVelocity[0], other.freestreamVelocity[0]) && sameBits(freestreamVelocity[1], other.freestreamVelocity[1]) &&
+           sameBits(freestreamVelocity[2], other.freestreamVelocity[2]) &&
+           sameBits(airDensity, other.airDensity) && sameBits(kinematicViscosity, other.kinematicViscosity) &&
+           sameBits(initialAngularVelocity, other.initialAngularVelocity) &&
+           sameBits(motorResistance, other.motorResistance) && sameBits(motorVelocityConstant, other.motorVelocityConstant) &&
+           sameBits(motorRotorMomentOfInertia, other.motorRotorMomentOfInertia) &&
+           sameBits(propellerRadius, other.propellerRadius) && numBlades == other.numBlades &&
+           sameBits(propellerMomentOfInertia, other.propellerMomentOfInertia) && sameBits(hubRadius, other.hubRadius) &&
+           sameBits(hubHieght, other.hubHieght) && sameBits(bladeChord, other.bladeChord) && sameBits(bladePitch, other.bladePitch) &&
+           bladeAirfoil == other.bladeAirfoil && samePolars;
+}
+
+inline uint64_t Configuration::hash() const
+{
+    using ConfigurationDetail::hashValue;
+    using ConfigurationDetail::hashPolar;
+
+    uint64_t hash = 0xcbf29ce484222325ull;
+    hashValue(hash, simTime); hashValue(hash, timeStep); hashValue(hash, radialStep); hashValue(hash, radialQuadrature);
+    hashValue(hash, freestreamVelocity[0]); hashValue(hash, freestreamVelocity[1]); hashValue(hash, freestreamVelocity[2]);
+    hashValue(hash, airDensity); hashValue(hash, kinematicViscosity);
+    hashValue(hash, initialAngularVelocity);
+    hashValue(hash, motorResistance); hashValue(hash, motorVelocityConstant); hashValue(hash, motorRotorMomentOfInertia);
+    hashValue(hash, propellerRadius); hashValue(hash, numBlades); hashValue(hash, propellerMomentOfInertia);
+    hashValue(hash, hubRadius); hashValue(hash, hubHieght); hashValue(hash, bladeChord); hashValue(hash, bladePitch);
+    hashValue(hash, bladeAirfoil);
+    hashValue(hash, polars != nullptr);
+    if (polars)
+    {
+        hashPolar(hash, polars->lift); hashPolar(hash, polars->drag);
+        hashPolar(hash, polars->reverseLift); hashPolar(hash, polars->reverseDrag);
+    }
+    return hash;
+}
+
 #endif // _CONFIGURATION_H_
\ No newline at end of file
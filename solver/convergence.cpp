@@ -0,0 +1,147 @@
+#include "convergence.h"
+#include "quadrature.h"
+#include "solver.h"
+#include "util.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace
+{
+    constexpr float RefinementRatio = 2.0f;
+
+    // Observed orders are clamped to this range. Oscillating or stalled convergence falls back to first
+    // order, which over- rather than under-estimates the remaining error.
+    constexpr float MinOrder = 1.0f;
+    constexpr float MaxOrder = 8.0f;
+
+    struct Extrapolation
+    {
+        float correction = 0; // Add to the finest value for the zero step limit
+        float order = MinOrder;
+    };
+
+    // Richardson extrapolation from three levels of one step, fine to coarse
+    Extrapolation richardson(float fine, float medium, float coarse)
+    {
+        const float fineDifference = fine - medium;
+        const float coarseDifference = medium - coarse;
+
+        Extrapolation extrapolation;
+        if (fineDifference == 0) return extrapolation;
+
+        if (fineDifference * coarseDifference > 0)
+        {
+            const float order = std::log(coarseDifference / fineDifference) / std::log(RefinementRatio);
+            extrapolation.order = std::clamp(std::isfinite(order) ? order : MinOrder, MinOrder, MaxOrder);
+        }
+        extrapolation.correction = fineDifference / (std::pow(RefinementRatio, extrapolation.order) - 1.0f);
+        return extrapolation;
+    }
+}
+
+float Convergence::settlingTime(const Solution& solution, float band)
+{
+    const size_t samples = solution.time.size();
+    if (samples < 2) return 0;
+
+    const float steady = solution.steadyState().angularVelocity;
+    const float tolerance = band * std::max(std::abs(steady), 1e-6f);
+
+    // The blade passing ripple never decays, so compare the centered mean over one revolution instead of
+    // the raw angular velocity. A barely turning rotor uses a tenth of the simulated time.
+    const float duration = solution.time.back() - solution.time.front();
+    const float revolution = std::abs(steady) > 0 ? 2.0f * Util::PI / std::abs(steady) : duration;
+    const float window = std::min(revolution, 0.1f * duration);
+    const size_t half = std::max<size_t>(1, static_cast<size_t>(0.5f * window / (duration / (samples - 1))));
+    if (2 * half >= samples) return solution.time.back();
+
+    std::vector<double> prefix(samples + 1, 0.0);
+    for (size_t t = 0; t < samples; ++t) prefix[t + 1] = prefix[t] + solution.angularVelocity[t];
+
+    // Last centered mean outside the band, scanning backwards
+    for (size_t t = samples - half; t-- > half;)
+    {
+        const double mean = (prefix[t + half + 1] - prefix[t - half]) / (2 * half + 1);
+        if (std::abs(mean - steady) > tolerance) return solution.time[t + 1];
+    }
+    return solution.time[half];
+}
+
+ConvergenceStudy Convergence::run(const Configuration configuration, const ConvergenceSettings settings, std::atomic<float>& progress)
+{
+    ConvergenceStudy study;
+    study.settings = settings;
+    const int levels = std::clamp(settings.levels, 3, 6);
+    study.settings.levels = levels;
+    progress = 0;
+
+    for (int t = 0; t < levels; ++t)
+    {
+        for (int r = 0; r < levels; ++r)
+        {
+            ConvergenceCase convergenceCase;
+            convergenceCase.timeLevel = t;
+            convergenceCase.radialLevel = r;
+            convergenceCase.timeStep = settings.coarsestTimeStep / std::pow(RefinementRatio, t);
+            convergenceCase.radialStep = settings.coarsestRadialStep / std::pow(RefinementRatio, r);
+            study.cases.push_back(convergenceCase);
+        }
+    }
+
+    // Finest cases first, they take longest and would otherwise leave one thread finishing alone
+    std::vector<size_t> order(study.cases.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = order.size() - 1 - i;
+
+    std::atomic<size_t> completed = 0;
+    Util::parallelFor(order.size(), [&](size_t i) {
+        ConvergenceCase& convergenceCase = study.cases[order[i]];
+        Configuration refined = configuration;
+        refined.timeStep = convergenceCase.timeStep;
+        refined.radialStep = convergenceCase.radialStep;
+
+        const auto start = std::chrono::steady_clock::now();
+        std::atomic<float> solveProgress = 0;
+        const Solution solution = Solver::solve(refined, solveProgress);
+        convergenceCase.seconds = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+
+        const SteadyState state = solution.steadyState();
+        convergenceCase.values = {state.angularVelocity, state.drag, settlingTime(solution)};
+        convergenceCase.cost = static_cast<double>(solution.time.size()) * Quadrature::radialStations(refined).radii.size();
+
+        progress = static_cast<float>(++completed) / order.size();
+    });
+
+    // Errors are assumed additive in the two steps: extrapolate along each one from the finest pair
+    auto at = [&](int t, int r) -> const ConvergenceCase& { return study.cases[t * levels + r]; };
+    const int finest = levels - 1;
+    for (size_t o = 0; o < ConvergenceOutputCount; ++o)
+    {
+        const Extrapolation time = richardson(at(finest, finest).values[o], at(finest - 1, finest).values[o], at(finest - 2, finest).values[o]);
+        const Extrapolation radial = richardson(at(finest, finest).values[o], at(finest, finest - 1).values[o], at(finest, finest - 2).values[o]);
+        study.extrapolated[o] = at(finest, finest).values[o] + time.correction + radial.correction;
+        study.timeOrder[o] = time.order;
+        study.radialOrder[o] = radial.order;
+    }
+
+    for (size_t i = 0; i < study.cases.size(); ++i)
+    {
+        ConvergenceCase& convergenceCase = study.cases[i];
+        convergenceCase.withinTolerance = true;
+        for (size_t o = 0; o < ConvergenceOutputCount; ++o)
+        {
+            const float scale = std::max(std::abs(study.extrapolated[o]), 1e-6f);
+            convergenceCase.errors[o] = std::abs(convergenceCase.values[o] - study.extrapolated[o]) / scale;
+            convergenceCase.withinTolerance = convergenceCase.withinTolerance && convergenceCase.errors[o] <= settings.tolerance;
+        }
+
+        if (convergenceCase.withinTolerance && (study.recommended < 0 || convergenceCase.cost < study.cases[study.recommended].cost))
+        {
+            study.recommended = static_cast<int>(i);
+        }
+    }
+
+    progress = 1;
+    return study;
+}
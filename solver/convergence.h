@@ -0,0 +1,67 @@
+#ifndef _CONVERGENCE_H_
+#define _CONVERGENCE_H_
+
+#include <array>
+#include <atomic>
+#include <vector>
+
+#include "configuration.h"
+#include "solution.h"
+
+struct ConvergenceSettings
+{
+    // Every level halves the step, so the finest pair is 2^(levels - 1) times finer than the coarsest
+    int levels = 4;
+    float coarsestTimeStep = 0.004f;
+    float coarsestRadialStep = 0.04f;
+
+    // Relative error every output must stay within
+    float tolerance = 0.01f;
+};
+
+// Outputs whose discretization error is estimated, in this order
+constexpr size_t ConvergenceOutputCount = 3;
+inline constexpr std::array<const char*, ConvergenceOutputCount> ConvergenceOutputNames = {"Steady Angular Velocity", "Steady Drag", "Time to Steady State"};
+
+struct ConvergenceCase
+{
+    int timeLevel = 0, radialLevel = 0;
+    float timeStep = 0, radialStep = 0;
+
+    // Blade section evaluations (time steps times radial stations) and the measured wall time of the solve
+    double cost = 0;
+    float seconds = 0;
+
+    std::array<float, ConvergenceOutputCount> values = {};
+
+    // Relative to the Richardson extrapolated values
+    std::array<float, ConvergenceOutputCount> errors = {};
+    bool withinTolerance = false;
+};
+
+struct ConvergenceStudy
+{
+    ConvergenceSettings settings;
+
+    // Every time step / radial step pair, row-major in (timeLevel, radialLevel)
+    std::vector<ConvergenceCase> cases;
+
+    // Zero step limit and the observed order of convergence in each step
+    std::array<float, ConvergenceOutputCount> extrapolated = {}, timeOrder = {}, radialOrder = {};
+
+    // Cheapest case within tolerance, -1 if even the finest pair misses it
+    int recommended = -1;
+};
+
+// Discretization convergence study over timeStep and radialStep.
+// Solves the full ladder of refinements in parallel, extrapolates each output to zero step along both steps
+// from the three finest levels, and measures every pair against that limit.
+namespace Convergence
+{
+    ConvergenceStudy run(const Configuration configuration, const ConvergenceSettings settings, std::atomic<float>& progress);
+
+    // Time after which the revolution averaged angular velocity stays within band of its steady value
+    float settlingTime(const Solution& solution, float band = 0.02f);
+}
+
+#endif // _CONVERGENCE_H_
@@ -0,0 +1,66 @@
+#include "cycle_statistics.h"
+#include "util.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+void CycleAccumulator::begin(float time)
+{
+    m_startTime = time;
+    m_count = 0;
+    m_angularVelocity = 0;
+    m_sum.fill(0);
+    m_sumSquares.fill(0);
+}
+
+void CycleAccumulator::push(float time, float angularPosition, float angularVelocity, float drag, float sideForce, float lift, float torque)
+{
+    if (!std::isfinite(angularPosition)) return;
+
+    const long long revolution = static_cast<long long>(std::floor(angularPosition / (2.0f * Util::PI)));
+    if (!m_started)
+    {
+        m_started = true;
+        m_revolution = revolution;
+        m_entered = angularPosition == static_cast<float>(revolution * 2.0 * Util::PI) ? 1 : 0;
+        begin(time);
+    }
+    else if (revolution != m_revolution)
+    {
+        const long long direction = revolution - m_revolution;
+        if (m_entered != 0 && direction == m_entered && m_count > 0)
+        {
+            m_statistics.startTime.push_back(m_startTime);
+            m_statistics.period.push_back(time - m_startTime);
+            m_statistics.angularVelocity.push_back(static_cast<float>(m_angularVelocity / m_count));
+            for (size_t s = 0; s < CycleSignalCount; ++s)
+            {
+                m_statistics.mean[s].push_back(static_cast<float>(m_sum[s] / m_count));
+                m_statistics.rms[s].push_back(static_cast<float>(std::sqrt(m_sumSquares[s] / m_count)));
+                m_statistics.peakToPeak[s].push_back(m_maximum[s] - m_minimum[s]);
+            }
+        }
+
+        // A step across more than one revolution enters the new one part way
+        m_entered = (direction == 1 || direction == -1) ? direction : 0;
+        m_revolution = revolution;
+        begin(time);
+    }
+
+    const std::array<float, CycleSignalCount> values = {drag, sideForce, lift, torque};
+    for (size_t s = 0; s < CycleSignalCount; ++s)
+    {
+        m_sum[s] += values[s];
+        m_sumSquares[s] += static_cast<double>(values[s]) * values[s];
+        m_minimum[s] = m_count == 0 ? values[s] : std::min(m_minimum[s], values[s]);
+        m_maximum[s] = m_count == 0 ? values[s] : std::max(m_maximum[s], values[s]);
+    }
+    m_angularVelocity += angularVelocity;
+    ++m_count;
+}
+
+CycleStatistics CycleAccumulator::finish()
+{
+    return std::move(m_statistics);
+}
@@ -0,0 +1,52 @@
+#ifndef _CYCLE_STATISTICS_H_
+#define _CYCLE_STATISTICS_H_
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+// Load signals summarized per revolution, in this order
+enum class CycleSignal : size_t { Drag = 0, SideForce, Lift, Torque, Count };
+constexpr size_t CycleSignalCount = static_cast<size_t>(CycleSignal::Count);
+inline constexpr std::array<const char*, CycleSignalCount> CycleSignalNames = {"Drag", "Side Force", "Lift", "Torque"};
+
+struct CycleStatistics
+{
+    // One row per completed revolution. The revolution the solve starts in (unless it starts on a revolution
+    // boundary) and the one still running at the end are only partly simulated and have no row.
+    std::vector<float> startTime, period, angularVelocity;
+    std::array<std::vector<float>, CycleSignalCount> mean, rms, peakToPeak;
+
+    size_t size() const { return startTime.size(); }
+};
+
+// Per revolution statistics fed one full rate time step at a time, nothing but the finished rows is kept.
+// A revolution is the rotor angle between two multiples of 2 pi, completed once the rotor leaves it through the
+// boundary opposite the one it came in through, so a rotor rocking across a boundary completes nothing.
+class CycleAccumulator
+{
+    public:
+        void push(float time, float angularPosition, float angularVelocity, float drag, float sideForce, float lift, float torque);
+
+        // Hands over the completed revolutions
+        CycleStatistics finish();
+
+    private:
+        void begin(float time);
+
+        CycleStatistics m_statistics;
+        bool m_started = false;
+        long long m_revolution = 0;
+
+        // Direction the current revolution was entered in, +1 through its lower boundary, -1 through its upper
+        // and 0 if the solve started inside it
+        long long m_entered = 0;
+
+        float m_startTime = 0;
+        size_t m_count = 0;
+        double m_angularVelocity = 0;
+        std::array<double, CycleSignalCount> m_sum = {}, m_sumSquares = {};
+        std::array<float, CycleSignalCount> m_minimum = {}, m_maximum = {};
+};
+
+#endif // _CYCLE_STATISTICS_H_
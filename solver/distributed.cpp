@@ -0,0 +1,613 @@
+#include "distributed.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <future>
+#include <iostream>
+#include <thread>
+
+#include "polar_import.h"
+#include "socket.h"
+#include "solver.h"
+#include "sweep_parameter.h"
+#include "util.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    enum class MessageType : uint8_t
+    {
+        Hello = 1,  // Worker -> coordinator: protocol version
+        Job,        // Coordinator -> worker: job index, configuration
+        Heartbeat,  // Worker -> coordinator: job index, progress
+        Result,     // Worker -> coordinator: job index, summary
+        Shutdown    // Coordinator -> worker
+    };
+
+    // Frames are a 4 byte payload length, a 1 byte type and the payload
+    constexpr size_t HeaderSize = 5;
+    constexpr uint32_t MaxPayload = 1 << 20;
+    constexpr int PollIntervalMs = 250;
+    constexpr auto HeartbeatInterval = std::chrono::seconds(1);
+
+    class WireWriter
+    {
+        public:
+            void u32(uint32_t value) { for (int i = 0; i < 4; ++i) m_payload.push_back(static_cast<uint8_t>(value >> (8 * i))); }
+            void f32(float value) { u32(std::bit_cast<uint32_t>(value)); }
+
+            bool send(const Socket& socket, MessageType type) const
+            {
+                std::vector<uint8_t> frame;
+                frame.reserve(HeaderSize + m_payload.size());
+                for (int i = 0; i < 4; ++i) frame.push_back(static_cast<uint8_t>(m_payload.size() >> (8 * i)));
+                frame.push_back(static_cast<uint8_t>(type));
+                frame.insert(frame.end(), m_payload.begin(), m_payload.end());
+                return socket.sendAll(frame.data(), frame.size());
+            }
+
+        private:
+            std::vector<uint8_t> m_payload;
+    };
+
+    class WireReader
+    {
+        public:
+            explicit WireReader(const std::vector<uint8_t>& payload) : m_payload(payload) {}
+
+            uint32_t u32()
+            {
+                if (m_position + 4 > m_payload.size())
+                {
+                    m_valid = false;
+                    return 0;
+                }
+                uint32_t value = 0;
+                for (int i = 0; i < 4; ++i) value |= static_cast<uint32_t>(m_payload[m_position++]) << (8 * i);
+                return value;
+            }
+            float f32() { return std::bit_cast<float>(u32()); }
+
+            // Bytes not read yet, bounds counts read from the payload
+            size_t remaining() const { return m_payload.size() - std::min(m_position, m_payload.size()); }
+
+            // Every field was present and nothing was left over
+            bool valid() const { return m_valid && m_position == m_payload.size(); }
+
+        private:
+            const std::vector<uint8_t>& m_payload;
+            size_t m_position = 0;
+            bool m_valid = true;
+    };
+
+    // Pops the first complete frame off buffer. False if it has not fully arrived yet, or if corrupt is set.
+    bool nextFrame(std::vector<uint8_t>& buffer, MessageType& type, std::vector<uint8_t>& payload, bool& corrupt)
+    {
+        corrupt = false;
+        if (buffer.size() < HeaderSize) return false;
+
+        uint32_t length = 0;
+        for (int i = 0; i < 4; ++i) length |= static_cast<uint32_t>(buffer[i]) << (8 * i);
+        if (length > MaxPayload || buffer[4] < static_cast<uint8_t>(MessageType::Hello) || buffer[4] > static_cast<uint8_t>(MessageType::Shutdown))
+        {
+            corrupt = true;
+            return false;
+        }
+        if (buffer.size() < HeaderSize + length) return false;
+
+        type = static_cast<MessageType>(buffer[4]);
+        payload.assign(buffer.begin() + HeaderSize, buffer.begin() + HeaderSize + length);
+        buffer.erase(buffer.begin(), buffer.begin() + HeaderSize + length);
+        return true;
+    }
+
+    // Blocks until a whole frame has arrived, false if the peer closed or sent garbage
+    bool receiveFrame(const Socket& socket, std::vector<uint8_t>& buffer, MessageType& type, std::vector<uint8_t>& payload)
+    {
+        bool corrupt = false;
+        while (!nextFrame(buffer, type, payload, corrupt))
+        {
+            if (corrupt || socket.receiveSome(buffer) <= 0) return false;
+        }
+        return true;
+    }
+
+    // Polar as Reynolds number tables of (angle of attack, coefficient) points
+    void writePolar(WireWriter& writer, const AeroCoefficientInterpolator& polar)
+    {
+        writer.u32(static_cast<uint32_t>(polar.coefficients().size()));
+        for (const auto& [reynolds, points] : polar.coefficients())
+        {
+            writer.f32(reynolds);
+            writer.u32(static_cast<uint32_t>(points.size()));
+            for (const auto& [alpha, coefficient] : points)
+            {
+                writer.f32(alpha);
+                writer.f32(coefficient);
+            }
+        }
+    }
+
+    AeroCoefficientInterpolator::CoefficientData readPolar(WireReader& reader)
+    {
+        AeroCoefficientInterpolator::CoefficientData data;
+        const uint32_t tables = reader.u32();
+        for (uint32_t i = 0; i < tables && reader.remaining() >= 8; ++i)
+        {
+            std::vector<std::pair<float, float>>& points = data[reader.f32()];
+            const uint32_t count = reader.u32();
+            if (count > reader.remaining() / 8) break;
+            points.resize(count);
+            for (auto& [alpha, coefficient] : points)
+            {
+                alpha = reader.f32();
+                coefficient = reader.f32();
+            }
+        }
+        return data;
+    }
+
+    void writeConfiguration(WireWriter& writer, const Configuration& configuration)
+    {
+        writer.f32(configuration.simTime);
+        writer.f32(configuration.timeStep);
+        writer.f32(configuration.radialStep);
+        writer.u32(static_cast<uint32_t>(configuration.radialQuadrature));
+        for (int i = 0; i < 3; ++i) writer.f32(configuration.freestreamVelocity[i]);
+        writer.f32(configuration.airDensity);
+        writer.f32(configuration.kinematicViscosity);
+        writer.f32(configuration.initialAngularVelocity);
+        writer.f32(configuration.motorResistance);
+        writer.f32(configuration.motorVelocityConstant);
+        writer.f32(configuration.motorRotorMomentOfInertia);
+        writer.f32(configuration.propellerRadius);
+        writer.u32(static_cast<uint32_t>(configuration.numBlades));
+        writer.f32(configuration.propellerMomentOfInertia);
+        writer.f32(configuration.hubRadius);
+        writer.f32(configuration.hubHieght);
+        for (const float chord : configuration.bladeChord) writer.f32(chord);
+        for (const float pitch : configuration.bladePitch) writer.f32(pitch);
+        writer.u32(static_cast<uint32_t>(configuration.bladeAirfoil));
+
+        // Imported polars travel with every job, workers have no access to the Fluent results
+        writer.u32(configuration.polars ? 1 : 0);
+        if (configuration.polars)
+        {
+            writePolar(writer, configuration.polars->lift);
+            writePolar(writer, configuration.polars->drag);
+            writePolar(writer, configuration.polars->reverseLift);
+            writePolar(writer, configuration.polars->reverseDrag);
+        }
+    }
+
+    Configuration readConfiguration(WireReader& reader)
+    {
+        Configuration configuration;
+        configuration.simTime = reader.f32();
+        configuration.timeStep = reader.f32();
+        configuration.radialStep = reader.f32();
+        configuration.radialQuadrature = static_cast<RadialQuadrature>(reader.u32());
+        for (int i = 0; i < 3; ++i) configuration.freestreamVelocity[i] = reader.f32();
+        configuration.airDensity = reader.f32();
+        configuration.kinematicViscosity = reader.f32();
+        configuration.initialAngularVelocity = reader.f32();
+        configuration.motorResistance = reader.f32();
+        configuration.motorVelocityConstant = reader.f32();
+        configuration.motorRotorMomentOfInertia = reader.f32();
+        configuration.propellerRadius = reader.f32();
+        configuration.numBlades = static_cast<int>(reader.u32());
+        configuration.propellerMomentOfInertia = reader.f32();
+        configuration.hubRadius = reader.f32();
+        configuration.hubHieght = reader.f32();
+        for (float& chord : configuration.bladeChord) chord = reader.f32();
+        for (float& pitch : configuration.bladePitch) pitch = reader.f32();
+        configuration.bladeAirfoil = static_cast<Airfoil>(reader.u32());
+        if (reader.u32() != 0)
+        {
+            // Members are initialized in order, the reads stay in the written order
+            PolarSet polars{readPolar(reader), readPolar(reader), readPolar(reader), readPolar(reader)};
+            configuration.polars = std::make_shared<const PolarSet>(std::move(polars));
+        }
+        return configuration;
+    }
+
+    void writeSummary(WireWriter& writer, const SolutionSummary& summary)
+    {
+        writer.f32(summary.steadyState.angularVelocity);
+        writer.f32(summary.steadyState.torque);
+        writer.f32(summary.steadyState.lift);
+        writer.f32(summary.steadyState.drag);
+        writer.f32(summary.steadyState.sideForce);
+        writer.f32(summary.steadyState.aerodynamicTorque);
+        writer.f32(summary.minAngularVelocity);
+        writer.f32(summary.maxAngularVelocity);
+        writer.f32(summary.maxDrag);
+        writer.u32(summary.samples);
+    }
+
+    SolutionSummary readSummary(WireReader& reader)
+    {
+        SolutionSummary summary;
+        summary.steadyState.angularVelocity = reader.f32();
+        summary.steadyState.torque = reader.f32();
+        summary.steadyState.lift = reader.f32();
+        summary.steadyState.drag = reader.f32();
+        summary.steadyState.sideForce = reader.f32();
+        summary.steadyState.aerodynamicTorque = reader.f32();
+        summary.minAngularVelocity = reader.f32();
+        summary.maxAngularVelocity = reader.f32();
+        summary.maxDrag = reader.f32();
+        summary.samples = reader.u32();
+        return summary;
+    }
+
+    // Whole argument must be a number
+    template<typename T>
+    bool parseArgument(const std::string& text, T& value)
+    {
+        std::istringstream stream(text);
+        stream >> value;
+        return !stream.fail() && stream.eof();
+    }
+
+    struct Connection
+    {
+        Socket socket;
+        std::vector<uint8_t> buffer;
+        bool ready = false; // Hello received
+        long job = -1;      // In flight job
+        Clock::time_point lastHeard = Clock::now();
+    };
+}
+
+SolutionSummary Distributed::summarize(const Solution& solution)
+{
+    SolutionSummary summary;
+    summary.steadyState = solution.steadyState();
+    summary.samples = static_cast<uint32_t>(solution.time.size());
+    if (!solution.angularVelocity.empty())
+    {
+        const auto [minIt, maxIt] = std::minmax_element(solution.angularVelocity.begin(), solution.angularVelocity.end());
+        summary.minAngularVelocity = *minIt;
+        summary.maxAngularVelocity = *maxIt;
+        summary.maxDrag = *std::max_element(solution.drag.begin(), solution.drag.end());
+    }
+    return summary;
+}
+
+DistributedSweep Distributed::makeSweep(const std::vector<DistributedAxis>& axes)
+{
+    DistributedSweep sweep;
+    sweep.axes = axes;
+
+    size_t total = axes.empty() ? 0 : 1;
+    for (const DistributedAxis& axis : axes) total *= std::max(axis.count, 1);
+
+    for (size_t i = 0; i < total; ++i)
+    {
+        // Last axis varies fastest
+        std::vector<float> point(axes.size());
+        size_t remainder = i;
+        for (size_t a = axes.size(); a-- > 0;)
+        {
+            const DistributedAxis& axis = axes[a];
+            const int count = std::max(axis.count, 1);
+            const int node = static_cast<int>(remainder % count);
+            remainder /= count;
+            point[a] = count == 1 ? axis.min : axis.min + (axis.max - axis.min) * node / (count - 1);
+        }
+        sweep.points.push_back(std::move(point));
+    }
+    sweep.results.resize(total);
+    return sweep;
+}
+
+std::vector<Configuration> Distributed::configurations(const Configuration& base, const DistributedSweep& sweep)
+{
+    std::vector<Configuration> jobs;
+    jobs.reserve(sweep.points.size());
+    for (const std::vector<float>& point : sweep.points)
+    {
+        Configuration configuration = base;
+        for (size_t a = 0; a < sweep.axes.size(); ++a) SweepParameters::All[sweep.axes[a].parameter].apply(configuration, point[a]);
+        jobs.push_back(configuration);
+    }
+    return jobs;
+}
+
+std::vector<DistributedResult> Distributed::coordinate(const std::vector<Configuration>& jobs, const CoordinatorSettings& settings)
+{
+    std::vector<DistributedResult> results(jobs.size());
+
+    Socket listener = Socket::listen(settings.address);
+    if (!listener.valid()) return results;
+    std::cout << "Coordinator listening on " << settings.address << " with " << jobs.size() << " jobs" << std::endl;
+
+    // Local workers are ordinary processes connecting back to us, std::system keeps this portable
+    std::vector<std::thread> localWorkers;
+    std::atomic<int> localRunning = settings.localWorkers;
+    for (int w = 0; w < settings.localWorkers; ++w)
+    {
+        const std::string command = "\"" + settings.executable + "\" worker --connect " + settings.address;
+        localWorkers.emplace_back([command, &localRunning]() {
+            std::system(command.c_str());
+            --localRunning;
+        });
+    }
+
+    // Lowest job index first, requeued jobs go to the front
+    std::deque<size_t> pending;
+    for (size_t j = 0; j < jobs.size(); ++j) pending.push_back(j);
+    size_t remaining = jobs.size();
+
+    std::vector<Connection> connections;
+    const auto timeout = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(settings.workerTimeout));
+
+    auto drop = [&](Connection& connection, const char* reason) {
+        if (connection.job >= 0)
+        {
+            DistributedResult& result = results[connection.job];
+            if (result.attempts < settings.maxAttempts)
+            {
+                std::cerr << "Worker " << reason << ", requeueing job " << connection.job << std::endl;
+                pending.push_front(connection.job);
+            }
+            else
+            {
+                std::cerr << "Worker " << reason << ", job " << connection.job << " failed after " << result.attempts << " attempts" << std::endl;
+                --remaining;
+            }
+        }
+        connection.job = -1;
+        connection.socket.close();
+    };
+
+    std::vector<const Socket*> sockets;
+    std::vector<bool> readable;
+    std::vector<uint8_t> payload;
+    Clock::time_point lastActivity = Clock::now();
+    // Once every job is done keep accepting until our own workers have connected and been shut down
+    while (remaining > 0 || localRunning > 0)
+    {
+        sockets.assign(1, &listener);
+        for (const Connection& connection : connections) sockets.push_back(&connection.socket);
+        if (!Socket::poll(sockets, PollIntervalMs, readable))
+        {
+            std::cerr << "Error polling coordinator sockets, " << remaining << " jobs failed" << std::endl;
+            break;
+        }
+
+        if (readable[0])
+        {
+            Connection connection;
+            connection.socket = listener.accept();
+            if (connection.socket.valid()) connections.push_back(std::move(connection));
+            lastActivity = Clock::now();
+        }
+
+        for (size_t c = 0; c < connections.size() && c + 1 < readable.size(); ++c)
+        {
+            Connection& connection = connections[c];
+            if (!readable[c + 1]) continue;
+            if (connection.socket.receiveSome(connection.buffer) <= 0)
+            {
+                drop(connection, "disconnected");
+                continue;
+            }
+            connection.lastHeard = lastActivity = Clock::now();
+
+            MessageType type;
+            bool corrupt = false;
+            while (connection.socket.valid() && nextFrame(connection.buffer, type, payload, corrupt))
+            {
+                WireReader reader(payload);
+                if (type == MessageType::Hello)
+                {
+                    const uint32_t version = reader.u32();
+                    if (!reader.valid() || version != ProtocolVersion) drop(connection, "speaks another protocol version");
+                    else connection.ready = true;
+                }
+                else if (type == MessageType::Heartbeat)
+                {
+                    reader.u32();
+                    reader.f32();
+                    if (!reader.valid()) drop(connection, "sent a corrupt heartbeat");
+                }
+                else if (type == MessageType::Result)
+                {
+                    const uint32_t job = reader.u32();
+                    const SolutionSummary summary = readSummary(reader);
+                    if (!reader.valid() || static_cast<long>(job) != connection.job)
+                    {
+                        drop(connection, "sent an unexpected result");
+                        continue;
+                    }
+
+                    // Results land at their job index, so arrival order never shows in the output
+                    results[job].completed = true;
+                    results[job].summary = summary;
+                    connection.job = -1;
+                    --remaining;
+                    std::cout << "Job " << job << " done, " << (jobs.size() - remaining) << "/" << jobs.size() << std::endl;
+                }
+                else drop(connection, "sent an unexpected message");
+            }
+            if (corrupt) drop(connection, "sent a corrupt frame");
+        }
+
+        // Silent workers are treated as lost, a solving worker heartbeats every second
+        const Clock::time_point now = Clock::now();
+        for (Connection& connection : connections)
+        {
+            if (connection.socket.valid() && connection.job >= 0 && now - connection.lastHeard > timeout) drop(connection, "timed out");
+        }
+
+        // Hand out work, one job per worker at a time
+        for (Connection& connection : connections)
+        {
+            if (pending.empty()) break;
+            if (!connection.socket.valid() || !connection.ready || connection.job >= 0) continue;
+
+            const size_t job = pending.front();
+            pending.pop_front();
+            connection.job = static_cast<long>(job);
+            connection.lastHeard = now;
+            ++results[job].attempts;
+
+            WireWriter writer;
+            writer.u32(static_cast<uint32_t>(job));
+            writeConfiguration(writer, jobs[job]);
+            if (!writer.send(connection.socket, MessageType::Job)) drop(connection, "disconnected");
+        }
+
+        if (remaining == 0)
+        {
+            for (Connection& connection : connections)
+            {
+                WireWriter().send(connection.socket, MessageType::Shutdown);
+                connection.socket.close();
+            }
+        }
+
+        connections.erase(std::remove_if(connections.begin(), connections.end(),
+                                         [](const Connection& connection) { return !connection.socket.valid(); }),
+                          connections.end());
+
+        // Nobody left to run the pending jobs, fail them instead of waiting for a worker that may never come
+        if (remaining > 0 && connections.empty() && localRunning == 0 && Clock::now() - lastActivity > timeout)
+        {
+            std::cerr << "No workers for " << settings.workerTimeout << " s, " << remaining << " jobs failed" << std::endl;
+            break;
+        }
+    }
+
+    connections.clear();
+    listener.close();
+
+    for (std::thread& worker : localWorkers) worker.join();
+    return results;
+}
+
+bool Distributed::work(const WorkerSettings& settings)
+{
+    Socket socket;
+    const Clock::time_point deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(settings.connectTimeout));
+    while (!(socket = Socket::connect(settings.address)).valid())
+    {
+        if (Clock::now() > deadline)
+        {
+            std::cerr << "Error connecting to coordinator: " << settings.address << std::endl;
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(PollIntervalMs));
+    }
+
+    WireWriter hello;
+    hello.u32(ProtocolVersion);
+    if (!hello.send(socket, MessageType::Hello)) return false;
+
+    // Jobs run back to back, each solve reuses the buffers of the one before
+    SolutionPool pool(1);
+
+    std::vector<uint8_t> buffer, payload;
+    MessageType type;
+    while (receiveFrame(socket, buffer, type, payload))
+    {
+        if (type == MessageType::Shutdown) return true;
+        if (type != MessageType::Job) break;
+
+        WireReader reader(payload);
+        const uint32_t job = reader.u32();
+        const Configuration configuration = readConfiguration(reader);
+        if (!reader.valid()) break;
+
+        std::atomic<float> progress = 0;
+        std::future<Solution> future = std::async(std::launch::async, Solver::solve, configuration, std::ref(progress), nullptr, nullptr, nullptr, &pool, nullptr);
+        while (future.wait_for(HeartbeatInterval) != std::future_status::ready)
+        {
+            WireWriter heartbeat;
+            heartbeat.u32(job);
+            heartbeat.f32(progress);
+            if (!heartbeat.send(socket, MessageType::Heartbeat)) break;
+        }
+
+        WireWriter result;
+        result.u32(job);
+        Solution solution = future.get();
+        writeSummary(result, summarize(solution));
+        pool.release(std::move(solution));
+        if (!result.send(socket, MessageType::Result)) break;
+    }
+
+    std::cerr << "Lost connection to coordinator: " << settings.address << std::endl;
+    return false;
+}
+
+int Distributed::coordinatorMain(const std::string& executable, const std::vector<std::string>& args)
+{
+    CoordinatorSettings settings;
+    settings.executable = executable;
+    std::vector<DistributedAxis> axes;
+    std::string output = "distributed_sweep.csv";
+    Configuration base;
+
+    bool valid = true;
+    for (size_t i = 0; i < args.size() && valid; ++i)
+    {
+        const bool hasValue = i + 1 < args.size();
+        if (args[i] == "--listen" && hasValue) settings.address = args[++i];
+        else if (args[i] == "--output" && hasValue) output = args[++i];
+        else if (args[i] == "--attempts" && hasValue) valid = parseArgument(args[++i], settings.maxAttempts) && settings.maxAttempts >= 1;
+        else if (args[i] == "--timeout" && hasValue) valid = parseArgument(args[++i], settings.workerTimeout) && settings.workerTimeout > 0;
+        else if (args[i] == "--local" && hasValue) valid = parseArgument(args[++i], settings.localWorkers) && settings.localWorkers >= 0;
+        else if (args[i] == "--polars" && hasValue) valid = (base.polars = PolarImport::load(args[++i])) != nullptr;
+        else if (args[i] == "--sweep" && hasValue)
+        {
+            // parameter:min:max:count
+            DistributedAxis axis;
+            char separator = 0;
+            std::istringstream stream(args[++i]);
+            stream >> axis.parameter >> separator >> axis.min >> separator >> axis.max >> separator >> axis.count;
+            valid = !stream.fail() && axis.parameter >= 0 && axis.parameter < static_cast<int>(SweepParameters::All.size()) && axis.count >= 1;
+            axes.push_back(axis);
+        }
+        else valid = false;
+    }
+
+    if (!valid || axes.empty())
+    {
+        std::cerr << "Usage: solver coordinator --sweep parameter:min:max:count [--sweep ...] [--listen tcp:host:port|unix:path]\n"
+                  << "                          [--output file.csv] [--attempts n] [--timeout seconds] [--local workers]\n"
+                  << "                          [--polars polars.csv]\n"
+                  << "Parameters:\n";
+        for (size_t p = 0; p < SweepParameters::All.size(); ++p) std::cerr << "  " << p << ": " << SweepParameters::All[p].name << "\n";
+        return 1;
+    }
+
+    DistributedSweep sweep = makeSweep(axes);
+    sweep.results = coordinate(configurations(base, sweep), settings);
+    Util::writeDistributedSweepToCsv(sweep, output);
+
+    const bool complete = std::all_of(sweep.results.begin(), sweep.results.end(), [](const DistributedResult& result) { return result.completed; });
+    return complete ? 0 : 1;
+}
+
+int Distributed::workerMain(const std::vector<std::string>& args)
+{
+    WorkerSettings settings;
+    for (size_t i = 0; i < args.size(); ++i)
+    {
+        const bool hasValue = i + 1 < args.size();
+        if (args[i] == "--connect" && hasValue) settings.address = args[++i];
+        else if (!(args[i] == "--connect-timeout" && hasValue && parseArgument(args[++i], settings.connectTimeout)))
+        {
+            std::cerr << "Usage: solver worker [--connect tcp:host:port|unix:path] [--connect-timeout seconds]" << std::endl;
+            return 1;
+        }
+    }
+    return work(settings) ? 0 : 1;
+}
@@ -0,0 +1,92 @@
+#ifndef _DISTRIBUTED_H_
+#define _DISTRIBUTED_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "configuration.h"
+#include "solution.h"
+
+// What a worker sends back for one solve, a few floats instead of the full time history
+struct SolutionSummary
+{
+    SteadyState steadyState;
+    float minAngularVelocity = 0, maxAngularVelocity = 0, maxDrag = 0;
+    uint32_t samples = 0;
+};
+
+// One swept Configuration parameter sampled at count evenly spaced values over [min, max]
+struct DistributedAxis
+{
+    int parameter = 0; // Index into SweepParameters::All
+    float min = 40;
+    float max = 120;
+    int count = 9;
+};
+
+struct DistributedResult
+{
+    bool completed = false;
+    int attempts = 0;
+    SolutionSummary summary;
+};
+
+// Full tensor grid over the axes, the first axis varying slowest. results[i] always belongs to points[i],
+// whichever worker solved it and in whatever order the results arrived.
+struct DistributedSweep
+{
+    std::vector<DistributedAxis> axes;
+    std::vector<std::vector<float>> points;
+    std::vector<DistributedResult> results;
+};
+
+struct CoordinatorSettings
+{
+    // tcp:host:port or unix:path. Workers are not authenticated, so only listen on every interface (tcp::port) on a
+    // trusted network.
+    std::string address = "tcp:localhost:5555";
+    int maxAttempts = 3;
+
+    // A worker that has not been heard from for this long is dropped and its job handed to another worker.
+    // With no worker connected or starting for this long, the jobs still pending fail and the run ends.
+    float workerTimeout = 30;
+
+    // Worker processes to start on this machine, they connect like any remote worker
+    int localWorkers = 0;
+    std::string executable;
+};
+
+struct WorkerSettings
+{
+    std::string address = "tcp:localhost:5555";
+
+    // Keep retrying the connection this long, so workers may be started before the coordinator
+    float connectTimeout = 30;
+};
+
+// Coordinator/worker mode of the headless solver.
+// The coordinator expands a sweep into jobs and hands them one at a time to every connected worker over a
+// length-prefixed little-endian binary protocol. Workers heartbeat while solving and return a SolutionSummary.
+// Jobs of workers that disconnect or go silent are requeued until they have been tried maxAttempts times.
+namespace Distributed
+{
+    constexpr uint32_t ProtocolVersion = 2;
+
+    SolutionSummary summarize(const Solution& solution);
+
+    DistributedSweep makeSweep(const std::vector<DistributedAxis>& axes);
+    std::vector<Configuration> configurations(const Configuration& base, const DistributedSweep& sweep);
+
+    // Solves every configuration on the connected workers, results are in configuration order
+    std::vector<DistributedResult> coordinate(const std::vector<Configuration>& jobs, const CoordinatorSettings& settings);
+
+    // Serves jobs until the coordinator shuts it down, false if the connection failed or was lost
+    bool work(const WorkerSettings& settings);
+
+    // Command line entry points, args excludes the program name and mode
+    int coordinatorMain(const std::string& executable, const std::vector<std::string>& args);
+    int workerMain(const std::vector<std::string>& args);
+}
+
+#endif // _DISTRIBUTED_H_
@@ -0,0 +1,152 @@
+#include "gorilla_codec.h"
+
+#include <bit>
+#include <cmath>
+
+namespace
+{
+    constexpr uint64_t mask(int bits)
+    {
+        return (uint64_t(1) << bits) - 1;
+    }
+
+    class BitWriter
+    {
+        public:
+            explicit BitWriter(std::vector<uint8_t>& bytes) : m_bytes(bytes) {}
+
+            // Writes the low bits of value, most significant first (bits <= 32)
+            void write(uint32_t value, int bits)
+            {
+                m_buffer = (m_buffer << bits) | (value & mask(bits));
+                m_count += bits;
+                while (m_count >= 8)
+                {
+                    m_count -= 8;
+                    m_bytes.push_back(static_cast<uint8_t>(m_buffer >> m_count));
+                }
+            }
+
+            void flush()
+            {
+                if (m_count > 0) m_bytes.push_back(static_cast<uint8_t>(m_buffer << (8 - m_count)));
+                m_count = 0;
+            }
+
+        private:
+            std::vector<uint8_t>& m_bytes;
+            uint64_t m_buffer = 0;
+            int m_count = 0;
+    };
+
+    class BitReader
+    {
+        public:
+            explicit BitReader(const std::vector<uint8_t>& bytes) : m_bytes(bytes) {}
+
+            uint32_t read(int bits)
+            {
+                while (m_count < bits)
+                {
+                    m_buffer = (m_buffer << 8) | (m_position < m_bytes.size() ? m_bytes[m_position++] : 0);
+                    m_count += 8;
+                }
+                m_count -= bits;
+                return static_cast<uint32_t>((m_buffer >> m_count) & mask(bits));
+            }
+
+        private:
+            const std::vector<uint8_t>& m_bytes;
+            size_t m_position = 0;
+            uint64_t m_buffer = 0;
+            int m_count = 0;
+    };
+
+    // Linear extrapolation of the previous two values. Solver output is smooth, so XORing against the
+    // prediction leaves far more leading zeros than XORing against the previous value alone.
+    uint32_t predict(const std::vector<float>& values, size_t i)
+    {
+        if (i < 2) return std::bit_cast<uint32_t>(values[i - 1]);
+        const float prediction = 2.0f * values[i - 1] - values[i - 2];
+        if (!std::isfinite(prediction)) return std::bit_cast<uint32_t>(values[i - 1]);
+        return std::bit_cast<uint32_t>(prediction);
+    }
+}
+
+std::vector<uint8_t> GorillaCodec::encode(const std::vector<float>& values)
+{
+    std::vector<uint8_t> bytes;
+    if (values.empty()) return bytes;
+
+    bytes.reserve(values.size());
+    BitWriter writer(bytes);
+
+    writer.write(std::bit_cast<uint32_t>(values[0]), 32);
+
+    int previousLeading = -1, previousTrailing = 0;
+    for (size_t i = 1; i < values.size(); ++i)
+    {
+        const uint32_t x = std::bit_cast<uint32_t>(values[i]) ^ predict(values, i);
+
+        if (x == 0)
+        {
+            // '0': same value
+            writer.write(0, 1);
+            continue;
+        }
+
+        const int leading = std::countl_zero(x);
+        const int trailing = std::countr_zero(x);
+
+        if (previousLeading != -1 && leading >= previousLeading && trailing >= previousTrailing)
+        {
+            // '10': meaningful bits fit inside the previous window
+            writer.write(0b10, 2);
+            writer.write(x >> previousTrailing, 32 - previousLeading - previousTrailing);
+        }
+        else
+        {
+            // '11': new window, 5 bits of leading zeros and 5 bits of (length - 1)
+            const int meaningful = 32 - leading - trailing;
+            writer.write(0b11, 2);
+            writer.write(leading, 5);
+            writer.write(meaningful - 1, 5);
+            writer.write(x >> trailing, meaningful);
+            previousLeading = leading;
+            previousTrailing = trailing;
+        }
+    }
+
+    writer.flush();
+    bytes.shrink_to_fit();
+    return bytes;
+}
+
+std::vector<float> GorillaCodec::decode(const std::vector<uint8_t>& bytes, size_t count)
+{
+    std::vector<float> values;
+    if (count == 0) return values;
+
+    values.reserve(count);
+    BitReader reader(bytes);
+
+    values.push_back(std::bit_cast<float>(reader.read(32)));
+
+    int leading = 0, trailing = 0;
+    for (size_t i = 1; i < count; ++i)
+    {
+        uint32_t x = 0;
+        if (reader.read(1) != 0)
+        {
+            if (reader.read(1) != 0)
+            {
+                leading = reader.read(5);
+                trailing = 32 - leading - (static_cast<int>(reader.read(5)) + 1);
+            }
+            x = reader.read(32 - leading - trailing) << trailing;
+        }
+        values.push_back(std::bit_cast<float>(predict(values, i) ^ x));
+    }
+
+    return values;
+}
@@ -0,0 +1,19 @@
+#ifndef _GORILLA_CODEC_H_
+#define _GORILLA_CODEC_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Gorilla style XOR compression for float time series.
+// Each value is XORed with a prediction from the previous values, exact predictions cost one bit and
+// close ones only store the meaningful bits between the leading and trailing zeros of the XOR.
+namespace GorillaCodec
+{
+    std::vector<uint8_t> encode(const std::vector<float>& values);
+
+    // count is the number of values that were encoded
+    std::vector<float> decode(const std::vector<uint8_t>& bytes, size_t count);
+}
+
+#endif // _GORILLA_CODEC_H_
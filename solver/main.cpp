@@ -1,9 +1,42 @@
 #include <iostream>
+#include <string>
+#include <vector>
 
 #include "app.h"
+#include "distributed.h"
+#include "polar_import.h"
+#include "sectional_loads.h"
 
-int main()
+int main(int argc, char* argv[])
 {
+    // Headless modes, no window is created
+    if (argc > 1)
+    {
+        const std::string mode = argv[1];
+        const std::vector<std::string> args(argv + 2, argv + argc);
+        if (mode == "coordinator") return Distributed::coordinatorMain(argv[0], args);
+        if (mode == "worker") return Distributed::workerMain(args);
+        if (mode == "sections") return SectionalLoads::exportMain(args);
+        if (mode == "import-polars")
+        {
+            if (args.empty() || args.size() > 2)
+            {
+                std::cerr << "Usage: solver import-polars <fluent project files directory> [output.csv]" << std::endl;
+                return 1;
+            }
+            PolarImportSettings settings;
+            settings.directory = args[0];
+            std::atomic<float> progress = 0;
+            const PolarImportResult result = PolarImport::run(settings, progress);
+            for (const std::string& warning : result.warnings) std::cerr << "Warning: " << warning << std::endl;
+            std::cout << result.points.size() << " design points, " << result.fromReports << " from report files, " << result.fromLog << " from the design point log" << std::endl;
+            return !result.points.empty() && PolarImport::save(*result.polars, args.size() > 1 ? args[1] : "polars.csv") ? 0 : 1;
+        }
+
+        std::cerr << "Unknown mode: " << mode << " (expected coordinator, worker, import-polars or sections)" << std::endl;
+        return 1;
+    }
+
     App app;
     app.run();
     
@@ -0,0 +1,96 @@
+#include "minmax_pyramid.h"
+
+#include <algorithm>
+
+void MinMaxPyramid::build(const std::vector<float>& x, const std::vector<const std::vector<float>*>& columns)
+{
+    // Levels are rebuilt into the storage of the previous build, a pooled solution of the same length allocates nothing.
+    // Sized up front, later levels point into earlier ones.
+    size_t levels = 0;
+    for (size_t points = x.size(); points > MinPoints; points = 2 * ((points + 2 * Branching - 1) / (2 * Branching))) ++levels;
+    m_levels.resize(levels);
+
+    const std::vector<float>* previousX = &x;
+    const std::vector<const std::vector<float>*>* previousColumns = &columns;
+    for (Level& level : m_levels)
+    {
+        reduce(*previousX, *previousColumns, level);
+
+        m_previousColumns.clear();
+        for (const std::vector<float>& column : level.columns) m_previousColumns.push_back(&column);
+        previousX = &level.x;
+        previousColumns = &m_previousColumns;
+    }
+}
+
+void MinMaxPyramid::clear()
+{
+    m_levels.clear();
+}
+
+MinMaxPyramid::View MinMaxPyramid::view(const std::vector<float>& x, const std::vector<float>& y, size_t column, double xMin, double xMax, float pixels) const
+{
+    const double budget = 2.0 * std::max(pixels, 1.0f);
+
+    // Walk from full resolution towards the coarsest level until the visible range fits the budget
+    View view = clip(x, y, xMin, xMax);
+    for (const Level& level : m_levels)
+    {
+        if (view.count <= budget) break;
+        view = clip(level.x, level.columns[column], xMin, xMax);
+    }
+    return view;
+}
+
+void MinMaxPyramid::reduce(const std::vector<float>& x, const std::vector<const std::vector<float>*>& columns, Level& level)
+{
+    // Both raw samples and min/max pairs are in time order, so every window of 2 * Branching values
+    // collapses into one min/max pair regardless of which level it came from
+    constexpr size_t Window = 2 * Branching;
+    const size_t buckets = (x.size() + Window - 1) / Window;
+
+    level.x.clear();
+    level.x.reserve(2 * buckets);
+    level.columns.resize(columns.size());
+    for (std::vector<float>& column : level.columns)
+    {
+        column.clear();
+        column.reserve(2 * buckets);
+    }
+
+    for (size_t b = 0; b < buckets; ++b)
+    {
+        const size_t begin = b * Window;
+        const size_t end = std::min(begin + Window, x.size());
+
+        level.x.push_back(x[begin]);
+        level.x.push_back(x[end - 1]);
+
+        for (size_t c = 0; c < columns.size(); ++c)
+        {
+            const std::vector<float>& y = *columns[c];
+            auto [minIt, maxIt] = std::minmax_element(y.begin() + begin, y.begin() + end);
+
+            // Keep the extremes in the order they occurred
+            if (minIt > maxIt) std::swap(minIt, maxIt);
+            level.columns[c].push_back(*minIt);
+            level.columns[c].push_back(*maxIt);
+        }
+    }
+}
+
+MinMaxPyramid::View MinMaxPyramid::clip(const std::vector<float>& x, const std::vector<float>& y, double xMin, double xMax)
+{
+    if (x.empty()) return {};
+
+    auto first = std::lower_bound(x.begin(), x.end(), static_cast<float>(xMin));
+    auto last = std::upper_bound(first, x.end(), static_cast<float>(xMax));
+
+    // Include one point either side so lines reach the plot edges
+    size_t begin = first - x.begin();
+    size_t end = last - x.begin();
+    if (begin > 0) --begin;
+    if (end < x.size()) ++end;
+
+    return {x.data() + begin, y.data() + begin, static_cast<int>(end - begin)};
+}
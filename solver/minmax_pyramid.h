@@ -0,0 +1,50 @@
+#ifndef _MINMAX_PYRAMID_H_
+#define _MINMAX_PYRAMID_H_
+
+#include <cstddef>
+#include <vector>
+
+// Level-of-detail pyramid over a set of columns that share one monotonic x column (time).
+// Every level keeps, per bucket, the min and max of each column in the order they occurred, and all
+// columns of a level share the same x pairs, so decimated points still line up across columns.
+// Level 0 is the full resolution data, which the pyramid does not own.
+class MinMaxPyramid
+{
+    public:
+        struct View
+        {
+            const float* x = nullptr;
+            const float* y = nullptr;
+            int count = 0;
+        };
+
+        // Each level reduces the previous one by this factor
+        static constexpr size_t Branching = 4;
+
+        // Levels stop being built once they have at most this many points
+        static constexpr size_t MinPoints = 1024;
+
+        void build(const std::vector<float>& x, const std::vector<const std::vector<float>*>& columns);
+        void clear();
+
+        // Points of the coarsest level that still has about two points per pixel over [xMin, xMax].
+        // x and y must be the full resolution data the pyramid was built from.
+        View view(const std::vector<float>& x, const std::vector<float>& y, size_t column, double xMin, double xMax, float pixels) const;
+
+        size_t levels() const { return m_levels.size(); }
+
+    private:
+        struct Level
+        {
+            std::vector<float> x;
+            std::vector<std::vector<float>> columns;
+        };
+
+        static void reduce(const std::vector<float>& x, const std::vector<const std::vector<float>*>& columns, Level& level);
+        static View clip(const std::vector<float>& x, const std::vector<float>& y, double xMin, double xMax);
+
+        std::vector<Level> m_levels;
+        std::vector<const std::vector<float>*> m_previousColumns;
+};
+
+#endif // _MINMAX_PYRAMID_H_
@@ -0,0 +1,149 @@
+#include "multi_rotor.h"
+#include "solver.h"
+
+#include <algorithm>
+
+namespace
+{
+    struct Rotor
+    {
+        Configuration configuration;
+        BladeGeometry geometry;
+        double hubDrag;
+        double motorDamping;
+        float x, y;
+    };
+
+    Configuration inFlight(Configuration rotor, const Configuration& flight)
+    {
+        rotor.simTime = flight.simTime;
+        rotor.timeStep = flight.timeStep;
+        rotor.freestreamVelocity = flight.freestreamVelocity;
+        rotor.airDensity = flight.airDensity;
+        rotor.kinematicViscosity = flight.kinematicViscosity;
+        return rotor;
+    }
+}
+
+const std::vector<float>& MultiRotorSolution::total(Total total) const
+{
+    switch (total)
+    {
+        case Total::Drag:      return drag;
+        case Total::SideForce: return sideForce;
+        default:               return totalYawMoment;
+    }
+}
+
+MinMaxPyramid::View MultiRotorSolution::view(Total total, double timeMin, double timeMax, float pixels) const
+{
+    return pyramid.view(time, this->total(total), static_cast<size_t>(total), timeMin, timeMax, pixels);
+}
+
+MultiRotorSteadyState MultiRotorSolution::steadyState(float window) const
+{
+    MultiRotorSteadyState state;
+    state.rotors.resize(rotors.size());
+    if (time.empty()) return state;
+
+    const size_t count = std::clamp<size_t>(static_cast<size_t>(time.size() * window), 1, time.size());
+    const size_t begin = time.size() - count;
+    auto mean = [&](const std::vector<float>& column) {
+        double sum = 0;
+        for (size_t t = begin; t < time.size(); ++t) sum += column[t];
+        return static_cast<float>(sum / count);
+    };
+
+    for (size_t r = 0; r < rotors.size(); ++r)
+    {
+        state.rotors[r] = {mean(rotors[r].drag), mean(rotors[r].sideForce), mean(yawMoment[r])};
+    }
+    state.total = {mean(drag), mean(sideForce), mean(totalYawMoment)};
+    return state;
+}
+
+MultiRotorSolution MultiRotor::solve(const MultiRotorConfiguration configuration, std::atomic<float>& progress, WorkerTeam* team)
+{
+    MultiRotorSolution result;
+    result.configuration = configuration;
+    progress = 0;
+
+    const Configuration& Flight = configuration.flight;
+    const size_t TimeSteps = (Flight.simTime / Flight.timeStep);
+    result.time = Util::linspace<float>(0, Flight.simTime, TimeSteps);
+    result.drag.assign(TimeSteps, 0.0f);
+    result.sideForce.assign(TimeSteps, 0.0f);
+    result.totalYawMoment.assign(TimeSteps, 0.0f);
+    if (configuration.rotors.empty() || TimeSteps == 0) return result;
+
+    std::vector<Rotor> rotors;
+    std::vector<SpectralAnalyzer> analyzers;
+    std::vector<CycleAccumulator> cycles(configuration.rotors.size());
+    rotors.reserve(configuration.rotors.size());
+    analyzers.reserve(configuration.rotors.size());
+    size_t sections = 0;
+    for (const RotorPlacement& placement : configuration.rotors)
+    {
+        const Configuration Rotor = inFlight(placement.configuration, Flight);
+        const BladeGeometry Geometry(Rotor);
+        rotors.push_back({Rotor, Geometry, Solver::hubDrag(Rotor),
+                          Rotor.motorDamping(), placement.x, placement.y});
+        analyzers.emplace_back(SpectralSettings(), TimeSteps, Rotor.timeStep, Rotor.numBlades);
+        sections += Geometry.offsetCos.size() * Geometry.radii.size();
+
+        Solution solution(TimeSteps);
+        solution.time = result.time;
+        if (!placement.name.empty()) solution.name = placement.name;
+        solution.angularPosition[0] = placement.phase;
+        solution.angularVelocity[0] = Rotor.initialAngularVelocity;
+        result.rotors.push_back(std::move(solution));
+        result.yawMoment.emplace_back(TimeSteps, 0.0f);
+    }
+
+    // Rotors are the unit of work, each one's kernel already vectorizes over its own sections
+    const bool Parallel = team && rotors.size() > 1 && sections >= SolverKernel::ParallelThreshold;
+
+    for (size_t t = 0; t < TimeSteps; ++t)
+    {
+        progress = static_cast<float>(t) / std::max<float>(TimeSteps - 1, 1);
+
+        auto step = [&](size_t r) {
+            const Rotor& rotor = rotors[r];
+            Solution& solution = result.rotors[r];
+            Solver::record(rotor.configuration, SolverKernel::evaluate(rotor.geometry, solution.angularPosition[t], solution.angularVelocity[t]), rotor.hubDrag, t, solution);
+            analyzers[r].push(solution.time[t], solution.angularPosition[t], solution.torque[t], solution.drag[t], solution.sideForce[t]);
+            cycles[r].push(solution.time[t], solution.angularPosition[t], solution.angularVelocity[t], solution.drag[t], solution.sideForce[t], solution.lift[t], solution.torque[t]);
+
+            // Forces at the rotor position, plus the reaction of the motor braking the rotor
+            result.yawMoment[r][t] = static_cast<float>(rotor.x * solution.sideForce[t] - rotor.y * solution.drag[t] + solution.angularVelocity[t] * rotor.motorDamping);
+
+            if (t + 1 < TimeSteps)
+            {
+                Solver::advance(rotor.configuration, solution.angularPosition[t], solution.angularVelocity[t], solution.angularAcceleration[t],
+                                solution.angularPosition[t + 1], solution.angularVelocity[t + 1]);
+            }
+        };
+        if (Parallel) team->run(rotors.size(), step);
+        else for (size_t r = 0; r < rotors.size(); ++r) step(r);
+
+        // Summed in rotor order, so totals do not depend on the threads
+        for (size_t r = 0; r < rotors.size(); ++r)
+        {
+            result.drag[t] += result.rotors[r].drag[t];
+            result.sideForce[t] += result.rotors[r].sideForce[t];
+            result.totalYawMoment[t] += result.yawMoment[r][t];
+        }
+    }
+
+    for (size_t r = 0; r < rotors.size(); ++r)
+    {
+        result.rotors[r].spectrum = analyzers[r].finish();
+        result.rotors[r].cycles = cycles[r].finish();
+        result.rotors[r].configuration = rotors[r].configuration;
+        result.rotors[r].clean();
+    }
+    result.pyramid.build(result.time, {&result.drag, &result.sideForce, &result.totalYawMoment});
+
+    progress = 1;
+    return result;
+}
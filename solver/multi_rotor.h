@@ -0,0 +1,72 @@
+#ifndef _MULTI_ROTOR_H_
+#define _MULTI_ROTOR_H_
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "configuration.h"
+#include "minmax_pyramid.h"
+#include "solution.h"
+#include "worker_team.h"
+
+// One rotor of a multi-rotor aircraft. Its axis is vertical at (x, y) in aircraft axes, x along the freestream and
+// y along the side force, and it starts phase radians into its rotation.
+struct RotorPlacement
+{
+    std::string name;
+    Configuration configuration;
+    float x = 0, y = 0;
+    float phase = 0;
+};
+
+// The time discretization and flight conditions of flight replace those of every rotor, the rest (geometry, motor,
+// initial angular velocity, radial discretization) stays per rotor
+struct MultiRotorConfiguration
+{
+    Configuration flight;
+    std::vector<RotorPlacement> rotors;
+};
+
+struct AircraftLoads
+{
+    float drag = 0, sideForce = 0, yawMoment = 0;
+};
+
+struct MultiRotorSteadyState
+{
+    std::vector<AircraftLoads> rotors;
+    AircraftLoads total;
+};
+
+struct MultiRotorSolution
+{
+    // Columns of the aircraft totals, in the order they are stored in the pyramid
+    enum class Total : size_t { Drag = 0, SideForce, YawMoment, Count };
+
+    MultiRotorConfiguration configuration;
+
+    // Full solution of every rotor, and its yaw moment about the aircraft origin
+    std::vector<Solution> rotors;
+    std::vector<std::vector<float>> yawMoment;
+
+    // Aircraft totals over time, with a level-of-detail pyramid for plotting
+    std::vector<float> time, drag, sideForce, totalYawMoment;
+    MinMaxPyramid pyramid;
+
+    const std::vector<float>& total(Total total) const;
+    MinMaxPyramid::View view(Total total, double timeMin, double timeMax, float pixels) const;
+
+    // Averages over the last window fraction of the simulated time
+    MultiRotorSteadyState steadyState(float window = 0.1f) const;
+};
+
+// Advances every rotor in one time loop with the single rotor solver's own arithmetic, so each rotor's solution
+// matches Solver::solve of its configuration. Rotors do not interact. With a team, the rotors of a step are
+// evaluated in parallel once the step has enough blade sections to pay for the synchronization.
+namespace MultiRotor
+{
+    MultiRotorSolution solve(const MultiRotorConfiguration configuration, std::atomic<float>& progress, WorkerTeam* team = nullptr);
+}
+
+#endif // _MULTI_ROTOR_H_
@@ -0,0 +1,101 @@
+#include "overlay_cache.h"
+
+#include <algorithm>
+#include <cmath>
+
+bool OverlayCache::update(const std::vector<size_t>& selection, SolutionStore& store)
+{
+    float end = 0;
+    for (const size_t index : selection) end = std::max(end, store.configuration(index).simTime);
+    const float bucketWidth = end / Buckets;
+    if (selection == m_selection && bucketWidth == m_bucketWidth) return false;
+
+    // A new grid invalidates every curve, otherwise only the newly selected ones are resampled
+    if (bucketWidth != m_bucketWidth)
+    {
+        m_curves.clear();
+        m_bucketWidth = bucketWidth;
+        m_time.resize(2 * Buckets);
+        for (size_t b = 0; b < Buckets; ++b)
+        {
+            m_time[2 * b] = (b + 0.25f) * bucketWidth;
+            m_time[2 * b + 1] = (b + 0.75f) * bucketWidth;
+        }
+    }
+
+    std::vector<Curve> curves;
+    curves.reserve(selection.size());
+    for (const size_t index : selection)
+    {
+        auto cached = std::find_if(m_curves.begin(), m_curves.end(), [&](const Curve& curve) { return curve.index == index; });
+        if (cached != m_curves.end())
+        {
+            curves.push_back(std::move(*cached));
+            continue;
+        }
+
+        // The store keeps few solutions decompressed, so each one is resampled right after it is fetched.
+        // Entries it could not reload are left out.
+        const Solution* solution = store.get(index);
+        if (!solution) continue;
+        Curve curve;
+        curve.index = index;
+        resample(*solution, curve);
+        curves.push_back(std::move(curve));
+    }
+    m_curves = std::move(curves);
+    m_selection = selection;
+    return true;
+}
+
+void OverlayCache::clear()
+{
+    m_selection.clear();
+    m_curves.clear();
+    m_time.clear();
+    m_bucketWidth = 0;
+}
+
+void OverlayCache::resample(const Solution& solution, Curve& curve) const
+{
+    curve.name = solution.name;
+    curve.color = solution.color;
+    curve.count = 0;
+    for (std::vector<float>& field : curve.fields) field.assign(2 * Buckets, 0.0f);
+
+    const std::vector<float>& time = solution.time;
+    if (time.empty() || m_bucketWidth <= 0) return;
+
+    size_t first = 0;
+    for (size_t b = 0; b < Buckets && first < time.size(); ++b)
+    {
+        const float bucketEnd = (b + 1) * m_bucketWidth;
+        size_t last = first;
+        while (last < time.size() && time[last] < bucketEnd) ++last;
+
+        for (size_t f = 0; f < FieldCount; ++f)
+        {
+            const std::vector<float>& y = solution.field(static_cast<Solution::Field>(f));
+            float* out = &curve.fields[f][2 * b];
+            if (last > first)
+            {
+                // Extremes in the order they occurred, like the pyramid levels
+                auto [minIt, maxIt] = std::minmax_element(y.begin() + first, y.begin() + last);
+                if (minIt > maxIt) std::swap(minIt, maxIt);
+                out[0] = *minIt;
+                out[1] = *maxIt;
+            }
+            else
+            {
+                // Solutions coarser than the grid leave buckets empty, they are interpolated at the bucket centre
+                const size_t next = std::min(last, time.size() - 1);
+                const size_t previous = next > 0 ? next - 1 : 0;
+                const float span = time[next] - time[previous];
+                const float weight = span > 0 ? std::clamp(((b + 0.5f) * m_bucketWidth - time[previous]) / span, 0.0f, 1.0f) : 0.0f;
+                out[0] = out[1] = y[previous] + weight * (y[next] - y[previous]);
+            }
+        }
+        curve.count = static_cast<int>(2 * (b + 1));
+        first = last;
+    }
+}
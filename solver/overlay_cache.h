@@ -0,0 +1,51 @@
+#ifndef _OVERLAY_CACHE_H_
+#define _OVERLAY_CACHE_H_
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "imgui.h"
+#include "solution.h"
+#include "solution_store.h"
+
+// Plot-ready curves of many solutions at once. Every solution is resampled once onto a shared time grid, as the min
+// and max of each bucket in the order they occurred, so peaks survive and all curves share one x buffer. Nothing is
+// recomputed until the set of solutions or the grid changes, which keeps dozens of overlaid curves cheap to draw.
+class OverlayCache
+{
+    public:
+        // Grid buckets over the longest solution, each drawn as a min/max pair, about three points per pixel of a plot column
+        static constexpr size_t Buckets = 1024;
+        static constexpr size_t FieldCount = static_cast<size_t>(Solution::Field::Count);
+
+        struct Curve
+        {
+            size_t index = 0;
+            std::string name;
+            ImVec4 color;
+            std::array<std::vector<float>, FieldCount> fields;
+
+            // Points of the shared grid this solution covers, shorter solutions stop early
+            int count = 0;
+        };
+
+        // Resamples the solutions that joined the selection, or all of them when the longest one changes the grid.
+        // Returns whether the curves changed.
+        bool update(const std::vector<size_t>& selection, SolutionStore& store);
+        void clear();
+
+        const std::vector<float>& time() const { return m_time; }
+        const std::vector<Curve>& curves() const { return m_curves; }
+
+    private:
+        void resample(const Solution& solution, Curve& curve) const;
+
+        std::vector<size_t> m_selection;
+        float m_bucketWidth = 0;
+        std::vector<float> m_time;
+        std::vector<Curve> m_curves;
+};
+
+#endif // _OVERLAY_CACHE_H_
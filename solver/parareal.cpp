@@ -0,0 +1,208 @@
+#include "parareal.h"
+#include "solver.h"
+#include "steady_solver.h"
+#include "util.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace
+{
+    struct RotorState
+    {
+        double angularPosition = 0, angularVelocity = 0;
+    };
+
+    // Coarse propagators. The large step model is the solver's own with a longer time step, so it follows the blade
+    // passing ripple and its phase. The cycle averaged model ignores the rotor position altogether and takes
+    // backward Euler steps, stable however long they are.
+    struct CoarsePropagator
+    {
+        const Configuration& configuration;
+        const BladeGeometry& geometry;
+        const PararealSettings& settings;
+
+        double averagedAcceleration(double angularVelocity) const
+        {
+            const double torque = SteadySolver::cycleAveragedForces(geometry, angularVelocity, settings.cycleSamples).torque - angularVelocity * configuration.motorDamping();
+            return torque / (configuration.propellerMomentOfInertia + configuration.motorRotorMomentOfInertia);
+        }
+
+        RotorState propagate(RotorState state, size_t fineSteps) const
+        {
+            if (settings.coarse == PararealCoarse::LargeStep)
+            {
+                const size_t steps = std::max<size_t>(1, (fineSteps + settings.coarseRatio - 1) / settings.coarseRatio);
+                Configuration coarse = configuration;
+                coarse.timeStep = static_cast<float>(fineSteps * static_cast<double>(configuration.timeStep) / steps);
+
+                float angularPosition = static_cast<float>(state.angularPosition), angularVelocity = static_cast<float>(state.angularVelocity);
+                for (size_t i = 0; i < steps; ++i)
+                {
+                    const float torque = SolverKernel::evaluate(geometry, angularPosition, angularVelocity).torque - angularVelocity * configuration.motorDamping();
+                    const float angularAcceleration = torque / (configuration.propellerMomentOfInertia + configuration.motorRotorMomentOfInertia);
+                    Solver::advance(coarse, angularPosition, angularVelocity, angularAcceleration, angularPosition, angularVelocity);
+                }
+                return {angularPosition, angularVelocity};
+            }
+
+            // Newton on w1 = w0 + h a(w1) with a secant slope, a few iterations are plenty for a coarse model
+            const int steps = std::max(settings.coarseSteps, 1);
+            const double h = fineSteps * static_cast<double>(configuration.timeStep) / steps;
+            for (int i = 0; i < steps; ++i)
+            {
+                double next = state.angularVelocity;
+                for (int iteration = 0; iteration < 4; ++iteration)
+                {
+                    const double delta = std::max(1e-3, 1e-4 * std::abs(next));
+                    const double acceleration = averagedAcceleration(next);
+                    const double slope = (averagedAcceleration(next + delta) - acceleration) / delta;
+                    const double residual = next - state.angularVelocity - h * acceleration;
+                    next -= residual / (1.0 - h * std::min(slope, 0.0));
+                }
+                state.angularPosition += h * next;
+                state.angularVelocity = next;
+            }
+            return state;
+        }
+    };
+
+    // Solver::solve's own time loop over steps [first, last), recorded into solution, returns the state at last
+    RotorState propagateFine(const Configuration& configuration, const BladeGeometry& geometry, double hubDrag,
+                             RotorState start, size_t first, size_t last, Solution& solution)
+    {
+        solution.angularPosition[first] = static_cast<float>(start.angularPosition);
+        solution.angularVelocity[first] = static_cast<float>(start.angularVelocity);
+
+        float endPosition = 0, endVelocity = 0;
+        for (size_t t = first; t < last; ++t)
+        {
+            Solver::record(configuration, SolverKernel::evaluate(geometry, solution.angularPosition[t], solution.angularVelocity[t]), hubDrag, t, solution);
+
+            // The step into the next slice is kept out of the shared arrays, that slice writes its own start
+            float& nextPosition = t + 1 < last ? solution.angularPosition[t + 1] : endPosition;
+            float& nextVelocity = t + 1 < last ? solution.angularVelocity[t + 1] : endVelocity;
+            Solver::advance(configuration, solution.angularPosition[t], solution.angularVelocity[t], solution.angularAcceleration[t], nextPosition, nextVelocity);
+        }
+        return {endPosition, endVelocity};
+    }
+}
+
+PararealResult Parareal::solve(const Configuration configuration, const PararealSettings settings, std::atomic<float>& progress)
+{
+    PararealResult result;
+    progress = 0;
+    const auto start = std::chrono::steady_clock::now();
+
+    const BladeGeometry Geometry(configuration);
+    const double HubDrag = Solver::hubDrag(configuration);
+    PararealSettings clamped = settings;
+    clamped.coarseRatio = std::max(clamped.coarseRatio, 1);
+    clamped.coarseSteps = std::max(clamped.coarseSteps, 1);
+    clamped.cycleSamples = std::max(clamped.cycleSamples, 1);
+    const CoarsePropagator Coarse{configuration, Geometry, clamped};
+
+    // Same discretization as Solver::solve
+    const size_t TimeSteps = (configuration.simTime / configuration.timeStep);
+    Solution& solution = result.solution;
+    solution = Solution(TimeSteps);
+    solution.time = Util::linspace<float>(0, configuration.simTime, TimeSteps);
+
+    // Clamped as an int first, a negative count must not wrap to a huge size_t
+    const size_t slices = std::min<size_t>(std::max(settings.slices, 1), std::max<size_t>(TimeSteps, 1));
+    std::vector<size_t> boundaries(slices + 1);
+    for (size_t n = 0; n <= slices; ++n) boundaries[n] = TimeSteps * n / slices;
+    auto length = [&](size_t n) { return boundaries[n + 1] - boundaries[n]; };
+
+    // Iteration zero, the coarse prediction of every slice boundary
+    std::vector<RotorState> states(slices + 1), coarse(slices), fine(slices);
+    states[0].angularVelocity = configuration.initialAngularVelocity;
+    for (size_t n = 0; n < slices; ++n)
+    {
+        coarse[n] = Coarse.propagate(states[n], length(n));
+        states[n + 1] = coarse[n];
+    }
+
+    size_t longestSlice = 0;
+    for (size_t n = 0; n < slices; ++n) longestSlice = std::max(longestSlice, length(n));
+
+    // Fine slices run concurrently and a geometry's segment cache is single threaded, so each slice has its own
+    const std::vector<BladeGeometry> sliceGeometries(slices, Geometry);
+
+    // Slices before the first one start from an exact state, their fine result is final
+    size_t first = 0;
+    while (first < slices)
+    {
+        Util::parallelFor(slices - first, [&](size_t i) {
+            const size_t n = first + i;
+            fine[n] = propagateFine(configuration, sliceGeometries[n], HubDrag, states[n], boundaries[n], boundaries[n + 1], solution);
+        });
+        result.fineSteps += boundaries[slices] - boundaries[first];
+        ++result.iterations;
+
+        // Sequential correction sweep: new coarse + fine - old coarse
+        double velocityChange = 0, positionChange = 0, velocityScale = 1, positionScale = 2.0 * Util::PI;
+        for (size_t n = first; n < slices; ++n)
+        {
+            RotorState corrected = fine[n];
+            if (n > first)
+            {
+                const RotorState predicted = Coarse.propagate(states[n], length(n));
+                corrected.angularPosition += predicted.angularPosition - coarse[n].angularPosition;
+                corrected.angularVelocity += predicted.angularVelocity - coarse[n].angularVelocity;
+                coarse[n] = predicted;
+            }
+
+            velocityChange = std::max(velocityChange, std::abs(corrected.angularVelocity - states[n + 1].angularVelocity));
+            positionChange = std::max(positionChange, std::abs(corrected.angularPosition - states[n + 1].angularPosition));
+            velocityScale = std::max(velocityScale, std::abs(corrected.angularVelocity));
+            positionScale = std::max(positionScale, std::abs(corrected.angularPosition));
+            states[n + 1] = corrected;
+        }
+        ++first;
+        progress = static_cast<float>(first) / slices;
+
+        // A diverged coarse prediction is never converged, whatever the comparisons of NaN say
+        if (std::isfinite(velocityChange) && std::isfinite(positionChange) &&
+            velocityChange <= settings.tolerance * velocityScale && positionChange <= settings.tolerance * positionScale)
+        {
+            result.converged = true;
+            break;
+        }
+    }
+    result.converged = result.converged || first == slices;
+
+    // Spectra and revolution statistics need the whole series in order, so they are computed once the slices are final
+    SpectralAnalyzer analyzer(SpectralSettings(), TimeSteps, configuration.timeStep, configuration.numBlades);
+    CycleAccumulator cycles;
+    for (size_t t = 0; t < TimeSteps; ++t)
+    {
+        analyzer.push(solution.time[t], solution.angularPosition[t], solution.torque[t], solution.drag[t], solution.sideForce[t]);
+        cycles.push(solution.time[t], solution.angularPosition[t], solution.angularVelocity[t], solution.drag[t], solution.sideForce[t], solution.lift[t], solution.torque[t]);
+    }
+    solution.spectrum = analyzer.finish();
+    solution.cycles = cycles.finish();
+    solution.configuration = configuration;
+    solution.clean();
+
+    result.seconds = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+    result.criticalPathSpeedup = static_cast<float>(TimeSteps) / (longestSlice * result.iterations);
+
+    if (settings.compareSerial)
+    {
+        const auto serialStart = std::chrono::steady_clock::now();
+        std::atomic<float> serialProgress = 0;
+        const Solution serial = Solver::solve(configuration, serialProgress);
+        result.serialSeconds = std::chrono::duration<float>(std::chrono::steady_clock::now() - serialStart).count();
+        result.speedup = result.serialSeconds / result.seconds;
+
+        for (size_t t = 0; t < TimeSteps; ++t)
+        {
+            result.maxDeviation = std::max(result.maxDeviation, std::abs(serial.angularVelocity[t] - solution.angularVelocity[t]));
+        }
+    }
+
+    progress = 1;
+    return result;
+}
@@ -0,0 +1,62 @@
+#ifndef _PARAREAL_H_
+#define _PARAREAL_H_
+
+#include <atomic>
+#include <cstddef>
+
+#include "configuration.h"
+#include "solution.h"
+
+enum class PararealCoarse
+{
+    LargeStep = 0,
+    CycleAveraged
+};
+
+struct PararealSettings
+{
+    // Time slices fine propagated in parallel. The speedup is bounded by slices / iterations, so several per core.
+    int slices = 64;
+
+    // Large step: the solver's own model with coarseRatio fine steps per step.
+    // Cycle averaged: coarseSteps backward Euler steps per slice on the torque averaged over cycleSamples positions.
+    PararealCoarse coarse = PararealCoarse::LargeStep;
+    int coarseRatio = 20;
+    int coarseSteps = 4;
+    int cycleSamples = 8;
+
+    // Converged once no slice boundary moves by more than this, relative to the largest angular velocity and position
+    float tolerance = 1e-4f;
+
+    // Also runs the serial solve, for the measured speedup and the deviation from it
+    bool compareSerial = true;
+};
+
+struct PararealResult
+{
+    Solution solution;
+    int iterations = 0;
+    bool converged = false;
+
+    // Fine time steps over all iterations, the serial solve takes one pass
+    size_t fineSteps = 0;
+
+    // Wall clock, and the speedup over the serial solve if it was run
+    float seconds = 0, serialSeconds = 0, speedup = 0;
+
+    // Speedup with one core per slice, serial steps over the longest slice times the iterations
+    float criticalPathSpeedup = 0;
+
+    // Largest angular velocity difference to the serial solve
+    float maxDeviation = 0;
+};
+
+// Parallel-in-time integration of Solver::solve. A cheap coarse propagator predicts the rotor state at the slice
+// boundaries, every slice is then integrated with the solver's own time step in parallel, and predictor-corrector
+// sweeps repeat until the boundaries stop moving. Slices before the first unconverged one are exact and skipped.
+namespace Parareal
+{
+    PararealResult solve(const Configuration configuration, const PararealSettings settings, std::atomic<float>& progress);
+}
+
+#endif // _PARAREAL_H_
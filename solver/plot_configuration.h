@@ -3,7 +3,6 @@
 
 #include "solution.h"
 
-#include <functional>
 #include <string>
 
 struct PlotConfiguration
@@ -11,7 +10,7 @@ struct PlotConfiguration
     std::string title;
     std::string xLabel;
     std::string yLabel;
-    std::function<const std::vector<float>&(const Solution&)> field;
+    Solution::Field field;
 };
 
 #endif // _PLOT_CONFIGURATION_H_
\ No newline at end of file
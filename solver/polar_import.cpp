@@ -0,0 +1,353 @@
+#include "polar_import.h"
+#include "util.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string_view>
+
+namespace
+{
+    // Hands out the lines of a file while holding one chunk of it, growing only for a line longer than a chunk
+    class ChunkedLineReader
+    {
+        public:
+            ChunkedLineReader(const std::string& path, size_t chunkSize) : m_file(path, std::ios::binary), m_buffer(std::max<size_t>(chunkSize, 256)) {}
+
+            bool valid() const { return m_file.is_open(); }
+
+            // Next line without its line ending, valid until the next call
+            bool next(std::string_view& line)
+            {
+                while (true)
+                {
+                    char* const data = m_buffer.data();
+                    char* const newline = std::find(data + m_begin, data + m_end, '\n');
+                    if (newline != data + m_end || (m_eof && m_begin < m_end))
+                    {
+                        line = std::string_view(data + m_begin, newline - (data + m_begin));
+                        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+                        m_begin = std::min<size_t>(newline - data + 1, m_end);
+                        return true;
+                    }
+                    if (m_eof) return false;
+
+                    // Keep the partial line and read the next chunk after it
+                    std::memmove(data, data + m_begin, m_end - m_begin);
+                    m_end -= m_begin;
+                    m_begin = 0;
+                    if (m_end == m_buffer.size()) m_buffer.resize(2 * m_buffer.size());
+
+                    m_file.read(m_buffer.data() + m_end, m_buffer.size() - m_end);
+                    m_end += m_file.gcount();
+                    m_eof = m_file.gcount() == 0;
+                }
+            }
+
+        private:
+            std::ifstream m_file;
+            std::vector<char> m_buffer;
+            size_t m_begin = 0, m_end = 0;
+            bool m_eof = false;
+    };
+
+    enum class Quantity { AngleOfAttack, Velocity, Lift, Drag, Other };
+
+    // Workbench output parameters are named after the Fluent report definitions, cl-op and cd-op here
+    Quantity quantityOf(std::string_view description)
+    {
+        std::string lower(description);
+        std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        if (lower.starts_with("aoa") || lower.starts_with("angle")) return Quantity::AngleOfAttack;
+        if (lower.starts_with("velocity")) return Quantity::Velocity;
+        if (lower.starts_with("cl")) return Quantity::Lift;
+        if (lower.starts_with("cd")) return Quantity::Drag;
+        return Quantity::Other;
+    }
+
+    std::vector<std::string_view> split(std::string_view line, char separator)
+    {
+        std::vector<std::string_view> fields;
+        size_t begin = 0;
+        while (true)
+        {
+            const size_t end = line.find(separator, begin);
+            fields.push_back(line.substr(begin, end == std::string_view::npos ? std::string_view::npos : end - begin));
+            if (end == std::string_view::npos) return fields;
+            begin = end + 1;
+        }
+    }
+
+    bool parseFloat(std::string_view text, float& value)
+    {
+        while (!text.empty() && text.front() == ' ') text.remove_prefix(1);
+        if (text.empty()) return false;
+        char* end = nullptr;
+        const std::string copy(text);
+        value = std::strtof(copy.c_str(), &end);
+        return end != copy.c_str();
+    }
+
+    // Design point log: every "# ,P1 - AoA [degree],..." block defines the parameters, a "Name,P1,..." line the
+    // columns and "DP n,..." lines the values. Later rows of a design point replace earlier ones.
+    bool readDesignPointLog(const std::string& path, size_t chunkSize, std::map<std::pair<int, int>, PolarDesignPoint>& points)
+    {
+        ChunkedLineReader reader(path, chunkSize);
+        if (!reader.valid()) return false;
+
+        struct Parameter { Quantity quantity; int system; };
+        std::map<std::string, Parameter, std::less<>> parameters;
+        std::vector<std::string> columns;
+
+        std::string_view line;
+        bool first = true;
+        while (reader.next(line))
+        {
+            if (first && line.starts_with("\xEF\xBB\xBF")) line.remove_prefix(3);
+            first = false;
+
+            if (line.starts_with("# ,"))
+            {
+                // Each system repeats the same parameters, the n-th occurrence of a quantity belongs to system n
+                parameters.clear();
+                std::array<int, 5> occurrences = {};
+                for (const std::string_view entry : split(line.substr(3), ','))
+                {
+                    const size_t dash = entry.find(" - ");
+                    if (dash == std::string_view::npos) continue;
+                    const Quantity quantity = quantityOf(entry.substr(dash + 3));
+                    parameters[std::string(entry.substr(0, dash))] = {quantity, occurrences[static_cast<int>(quantity)]++};
+                }
+            }
+            else if (line.starts_with("Name,"))
+            {
+                columns.clear();
+                for (const std::string_view column : split(line, ',')) columns.emplace_back(column);
+            }
+            else if (line.starts_with("DP "))
+            {
+                const std::vector<std::string_view> fields = split(line, ',');
+                const int designPoint = std::atoi(std::string(fields[0].substr(3)).c_str());
+                for (size_t c = 1; c < fields.size() && c < columns.size(); ++c)
+                {
+                    const auto parameter = parameters.find(columns[c]);
+                    float value = 0;
+                    if (parameter == parameters.end() || !parseFloat(fields[c], value)) continue;
+
+                    PolarDesignPoint& point = points[{designPoint, parameter->second.system}];
+                    point.designPoint = designPoint;
+                    point.system = parameter->second.system;
+                    switch (parameter->second.quantity)
+                    {
+                        case Quantity::AngleOfAttack: point.angleOfAttack = value; break;
+                        case Quantity::Velocity:      point.velocity = value; break;
+                        case Quantity::Lift:          point.lift = value; break;
+                        case Quantity::Drag:          point.drag = value; break;
+                        default: break;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    // Fluent report file: a quoted title, the quoted column names, then one line per iteration. The last iteration
+    // is the converged value, the spread over the last few tells whether it had settled.
+    void readReportFile(const std::string& path, const PolarImportSettings& settings, PolarDesignPoint& point, std::vector<std::string>& warnings)
+    {
+        ChunkedLineReader reader(path, settings.chunkSize);
+        if (!reader.valid()) return;
+
+        std::vector<Quantity> quantities;
+        const size_t window = std::max(settings.convergenceIterations, 1);
+        std::vector<std::vector<float>> recent;
+        size_t iterations = 0;
+
+        std::string_view line;
+        while (reader.next(line))
+        {
+            if (line.starts_with("\"Iteration\""))
+            {
+                quantities.clear();
+                for (const std::string_view name : split(line, '"'))
+                {
+                    if (name.find_first_not_of(' ') != std::string_view::npos && name != "Iteration") quantities.push_back(quantityOf(name));
+                }
+                recent.assign(quantities.size(), std::vector<float>(window, 0.0f));
+                continue;
+            }
+            if (line.empty() || !std::isdigit(static_cast<unsigned char>(line.front())) || quantities.empty()) continue;
+
+            const std::vector<std::string_view> fields = split(line, ' ');
+            for (size_t q = 0; q < quantities.size() && q + 1 < fields.size(); ++q)
+            {
+                parseFloat(fields[q + 1], recent[q][iterations % window]);
+            }
+            ++iterations;
+        }
+        if (iterations == 0) return;
+
+        for (size_t q = 0; q < quantities.size(); ++q)
+        {
+            const float last = recent[q][(iterations - 1) % window];
+            if (quantities[q] == Quantity::Lift) point.lift = last;
+            else if (quantities[q] == Quantity::Drag) point.drag = last;
+            else continue;
+            point.fromReports = true;
+
+            const auto [lo, hi] = std::minmax_element(recent[q].begin(), recent[q].begin() + std::min(window, iterations));
+            if (*hi - *lo > settings.convergenceTolerance * std::max(std::abs(last), 0.01f))
+            {
+                point.converged = false;
+                warnings.push_back(path + ": still changing by " + std::to_string(*hi - *lo) + " over the last iterations");
+            }
+        }
+    }
+
+    float roundedReynolds(float velocity, const PolarImportSettings& settings)
+    {
+        const double reynolds = std::abs(velocity) * settings.chord / settings.kinematicViscosity;
+        if (reynolds <= 0) return 0;
+        const double scale = std::pow(10.0, std::floor(std::log10(reynolds)) - 1);
+        return static_cast<float>(std::round(reynolds / scale) * scale);
+    }
+
+    AeroCoefficientInterpolator::CoefficientData table(const std::vector<PolarDesignPoint>& points, int system, bool lift)
+    {
+        AeroCoefficientInterpolator::CoefficientData data;
+        for (const PolarDesignPoint& point : points)
+        {
+            if (point.system != system) continue;
+            const float alpha = static_cast<float>(point.angleOfAttack * 3.14159265358979 / 180.0);
+            data[point.reynolds].push_back({alpha, lift ? point.lift : point.drag});
+        }
+        return data;
+    }
+}
+
+PolarImportResult PolarImport::run(const PolarImportSettings settings, std::atomic<float>& progress)
+{
+    PolarImportResult result;
+    progress = 0;
+    const auto start = std::chrono::steady_clock::now();
+
+    const std::filesystem::path root(settings.directory);
+    std::map<std::pair<int, int>, PolarDesignPoint> logged;
+    if (!readDesignPointLog((root / "user_files" / "DesignPointLog.csv").string(), settings.chunkSize, logged))
+    {
+        std::cerr << "Error opening design point log in: " << settings.directory << std::endl;
+    }
+    for (const auto& [key, point] : logged) result.points.push_back(point);
+
+    // Every design point and system reads its own report files, which replace the logged values when present
+    std::vector<std::vector<std::string>> warnings(result.points.size());
+    std::atomic<size_t> completed = 0;
+    Util::parallelFor(result.points.size(), [&](size_t i) {
+        PolarDesignPoint& point = result.points[i];
+        const std::string system = point.system == 0 ? "FFF" : "FFF-" + std::to_string(point.system);
+        const std::filesystem::path fluent = root / ("dp" + std::to_string(point.designPoint)) / system / "Fluent";
+
+        std::error_code error;
+        for (const auto& entry : std::filesystem::directory_iterator(fluent, error))
+        {
+            if (entry.path().filename().string().ends_with("-rfile.out")) readReportFile(entry.path().string(), settings, point, warnings[i]);
+        }
+        point.reynolds = roundedReynolds(point.velocity, settings);
+        progress = static_cast<float>(++completed) / result.points.size();
+    });
+
+    for (size_t i = 0; i < result.points.size(); ++i)
+    {
+        ++(result.points[i].fromReports ? result.fromReports : result.fromLog);
+        result.warnings.insert(result.warnings.end(), warnings[i].begin(), warnings[i].end());
+    }
+
+    // Systems without design points keep the built-in tables
+    auto polar = [&](int system, bool lift, const AeroCoefficientInterpolator& fallback) {
+        AeroCoefficientInterpolator::CoefficientData data = table(result.points, system, lift);
+        if (!data.empty()) return AeroCoefficientInterpolator(data);
+        result.warnings.push_back("No design points for system " + std::to_string(system) + ", keeping the built-in " + (lift ? "lift" : "drag") + " polar");
+        return fallback;
+    };
+    result.polars = std::make_shared<const PolarSet>(PolarSet{
+        polar(0, true, AeroCoefficientInterpolator::Dae51Lift), polar(0, false, AeroCoefficientInterpolator::Dae51Drag),
+        polar(1, true, AeroCoefficientInterpolator::Dae51LiftReversed), polar(1, false, AeroCoefficientInterpolator::Dae51DragReversed)});
+
+    result.seconds = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+    progress = 1;
+    return result;
+}
+
+namespace
+{
+    constexpr std::array<const char*, 4> PolarNames = {"Lift", "Drag", "Reverse Lift", "Reverse Drag"};
+}
+
+bool PolarImport::save(const PolarSet& polars, const std::string& filepath)
+{
+    std::ofstream polarFile(filepath);
+    if (!polarFile.is_open())
+    {
+        std::cerr << "Error opening file for writing: " << filepath << std::endl;
+        return false;
+    }
+
+    polarFile << "Polar,Reynolds,Alpha (rad),Coefficient\n";
+    polarFile << std::setprecision(9);
+    const std::array<const AeroCoefficientInterpolator*, 4> tables = {&polars.lift, &polars.drag, &polars.reverseLift, &polars.reverseDrag};
+    for (size_t p = 0; p < tables.size(); ++p)
+    {
+        for (const auto& [reynolds, points] : tables[p]->coefficients())
+        {
+            for (const auto& [alpha, coefficient] : points)
+            {
+                polarFile << PolarNames[p] << "," << reynolds << "," << alpha << "," << coefficient << "\n";
+            }
+        }
+    }
+
+    polarFile.close();
+    return true;
+}
+
+std::shared_ptr<const PolarSet> PolarImport::load(const std::string& filepath)
+{
+    ChunkedLineReader reader(filepath, PolarImportSettings().chunkSize);
+    if (!reader.valid())
+    {
+        std::cerr << "Error opening file for reading: " << filepath << std::endl;
+        return nullptr;
+    }
+
+    std::array<AeroCoefficientInterpolator::CoefficientData, 4> tables;
+    std::string_view line;
+    reader.next(line); // Header
+    while (reader.next(line))
+    {
+        if (line.empty()) continue;
+        const std::vector<std::string_view> fields = split(line, ',');
+        const auto name = std::find(PolarNames.begin(), PolarNames.end(), fields[0]);
+        float reynolds = 0, alpha = 0, coefficient = 0;
+        if (fields.size() != 4 || name == PolarNames.end() ||
+            !parseFloat(fields[1], reynolds) || !parseFloat(fields[2], alpha) || !parseFloat(fields[3], coefficient))
+        {
+            std::cerr << "Error reading polar row: " << line << std::endl;
+            return nullptr;
+        }
+        tables[name - PolarNames.begin()][reynolds].push_back({alpha, coefficient});
+    }
+
+    if (std::any_of(tables.begin(), tables.end(), [](const auto& table) { return table.empty(); }))
+    {
+        std::cerr << "Error reading polars, all of lift, drag, reverse lift and reverse drag are needed: " << filepath << std::endl;
+        return nullptr;
+    }
+    return std::make_shared<const PolarSet>(PolarSet{tables[0], tables[1], tables[2], tables[3]});
+}
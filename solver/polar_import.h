@@ -0,0 +1,63 @@
+#ifndef _POLAR_IMPORT_H_
+#define _POLAR_IMPORT_H_
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "configuration.h"
+
+struct PolarImportSettings
+{
+    // Workbench project files directory, holding user_files/DesignPointLog.csv and one dpN directory per design point
+    std::string directory = "ansys-fluent-analysis/airfoil_model_files";
+
+    // Reynolds number of a design point, velocity * chord / kinematic viscosity of the CFD model, rounded to two
+    // significant figures so the design points of one campaign share a table
+    float chord = 1.0f;
+    float kinematicViscosity = 0.00001461f;
+
+    // Files are read this many bytes at a time whatever their size
+    size_t chunkSize = 64 * 1024;
+
+    // A report file is flagged unconverged when its last iterations still spread by more than the tolerance
+    int convergenceIterations = 10;
+    float convergenceTolerance = 0.01f;
+};
+
+// One Fluent system of a design point: system 0 is the airfoil, system 1 the reversed airfoil
+struct PolarDesignPoint
+{
+    int designPoint = 0;
+    int system = 0;
+    float angleOfAttack = 0, velocity = 0, reynolds = 0;
+    float lift = 0, drag = 0;
+
+    // Coefficients from the system's cl/cd report files, otherwise the design point log's output parameters
+    bool fromReports = false;
+    bool converged = true;
+};
+
+struct PolarImportResult
+{
+    std::vector<PolarDesignPoint> points;
+    std::shared_ptr<const PolarSet> polars;
+    std::vector<std::string> warnings;
+    size_t fromReports = 0, fromLog = 0;
+    float seconds = 0;
+};
+
+// Polars straight from a Workbench campaign of Fluent design points. Fluent's reduced results, the report files of
+// every design point and Workbench's design point log, are streamed a chunk at a time, the design points in parallel.
+namespace PolarImport
+{
+    PolarImportResult run(const PolarImportSettings settings, std::atomic<float>& progress);
+
+    // Polar tables as CSV, one row per point: polar, Reynolds number, angle of attack (rad), coefficient
+    bool save(const PolarSet& polars, const std::string& filepath);
+    std::shared_ptr<const PolarSet> load(const std::string& filepath);
+}
+
+#endif // _POLAR_IMPORT_H_
@@ -0,0 +1,87 @@
+#include "quadrature.h"
+
+#include <algorithm>
+#include <cmath>
+
+RadialStations Quadrature::midpoint(float start, float end, size_t n)
+{
+    RadialStations stations;
+    const double step = (static_cast<double>(end) - start) / n;
+    for (size_t i = 0; i < n; ++i)
+    {
+        stations.radii.push_back(static_cast<float>(start + (i + 0.5) * step));
+        stations.weights.push_back(static_cast<float>(step));
+    }
+    return stations;
+}
+
+RadialStations Quadrature::gaussLegendre(float start, float end, size_t n)
+{
+    constexpr double Pi = 3.14159265358979323846;
+
+    RadialStations stations;
+    stations.radii.resize(n);
+    stations.weights.resize(n);
+
+    const double center = 0.5 * (static_cast<double>(end) + start);
+    const double halfLength = 0.5 * (static_cast<double>(end) - start);
+
+    // Roots are symmetric, Newton iterate on the upper half from the Chebyshev estimate
+    for (size_t i = 0; i < (n + 1) / 2; ++i)
+    {
+        double x = std::cos(Pi * (i + 0.75) / (n + 0.5));
+        double derivative = 0;
+        for (int iteration = 0; iteration < 100; ++iteration)
+        {
+            // Legendre recurrence for P_n(x), derivative from P_n and P_{n-1}
+            double p0 = 1, p1 = 0;
+            for (size_t k = 1; k <= n; ++k)
+            {
+                const double p2 = p1;
+                p1 = p0;
+                p0 = ((2.0 * k - 1) * x * p1 - (k - 1.0) * p2) / k;
+            }
+            derivative = n * (x * p0 - p1) / (x * x - 1);
+
+            const double previous = x;
+            x -= p0 / derivative;
+            if (std::abs(x - previous) < 1e-15) break;
+        }
+
+        const double weight = 2 / ((1 - x * x) * derivative * derivative);
+        stations.radii[i] = static_cast<float>(center - halfLength * x);
+        stations.radii[n - 1 - i] = static_cast<float>(center + halfLength * x);
+        stations.weights[i] = static_cast<float>(halfLength * weight);
+        stations.weights[n - 1 - i] = static_cast<float>(halfLength * weight);
+    }
+    return stations;
+}
+
+RadialStations Quadrature::tipCosine(float start, float end, size_t n)
+{
+    constexpr double HalfPi = 1.57079632679489661923;
+
+    RadialStations stations;
+    const double length = static_cast<double>(end) - start;
+    const double step = 1.0 / n;
+    for (size_t i = 0; i < n; ++i)
+    {
+        const double s = (i + 0.5) * step;
+        stations.radii.push_back(static_cast<float>(start + length * std::sin(HalfPi * s)));
+        stations.weights.push_back(static_cast<float>(length * HalfPi * std::cos(HalfPi * s) * step));
+    }
+    return stations;
+}
+
+RadialStations Quadrature::radialStations(const Configuration& configuration)
+{
+    const float bladeLength = configuration.propellerRadius - configuration.hubRadius;
+    const size_t n = std::max<size_t>(1, static_cast<size_t>(std::lround(bladeLength / configuration.radialStep)));
+
+    switch (configuration.radialQuadrature)
+    {
+        case RadialQuadrature::GaussLegendre: return gaussLegendre(configuration.hubRadius, configuration.propellerRadius, n);
+        case RadialQuadrature::TipCosine:     return tipCosine(configuration.hubRadius, configuration.propellerRadius, n);
+        default:                              return midpoint(configuration.hubRadius, configuration.propellerRadius, n);
+    }
+}
@@ -0,0 +1,34 @@
+#ifndef _QUADRATURE_H_
+#define _QUADRATURE_H_
+
+#include <array>
+#include <vector>
+
+#include "configuration.h"
+
+// Section radii and the span each one stands for in the blade integral
+struct RadialStations
+{
+    std::vector<float> radii;
+    std::vector<float> weights;
+};
+
+// Display names of RadialQuadrature, in enum order
+inline constexpr std::array<const char*, 3> RadialQuadratureNames = { "Midpoint", "Gauss-Legendre", "Tip-Clustered Cosine" };
+
+namespace Quadrature
+{
+    // n sections at the centres of equal intervals
+    RadialStations midpoint(float start, float end, size_t n);
+
+    // n point Gauss-Legendre rule, exact for polynomials up to degree 2n - 1
+    RadialStations gaussLegendre(float start, float end, size_t n);
+
+    // Midpoint rule in s under r = start + (end - start) sin(pi s / 2), clustering sections towards the tip
+    RadialStations tipCosine(float start, float end, size_t n);
+
+    // Stations over the blade for the configuration's scheme, with about one section per radialStep
+    RadialStations radialStations(const Configuration& configuration);
+}
+
+#endif // _QUADRATURE_H_
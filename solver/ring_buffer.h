@@ -0,0 +1,80 @@
+#ifndef _RING_BUFFER_H_
+#define _RING_BUFFER_H_
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <vector>
+
+// Lock-free single-producer/single-consumer ring buffer.
+// push() is only ever called from one thread (the solver) and pop() from one other thread (the renderer).
+// Neither side blocks: a full buffer drops the item instead of waiting on the consumer.
+template<typename T>
+class RingBuffer
+{
+    public:
+        explicit RingBuffer(size_t capacity) : m_buffer(capacity), m_mask(capacity - 1)
+        {
+            assert(capacity >= 2 && (capacity & (capacity - 1)) == 0 && "Capacity must be a power of two");
+        }
+
+        RingBuffer(const RingBuffer&) = delete;
+        RingBuffer& operator=(const RingBuffer&) = delete;
+
+        // Producer side. Returns false (and drops the item) if the buffer is full.
+        bool push(const T& item) noexcept
+        {
+            const size_t tail = m_tail.load(std::memory_order_relaxed);
+            if (tail - m_cachedHead > m_mask)
+            {
+                // Only touch the consumer's cache line when our cached view says we are full
+                m_cachedHead = m_head.load(std::memory_order_acquire);
+                if (tail - m_cachedHead > m_mask) return false;
+            }
+            m_buffer[tail & m_mask] = item;
+            m_tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer side. Returns false if the buffer is empty.
+        bool pop(T& item) noexcept
+        {
+            const size_t head = m_head.load(std::memory_order_relaxed);
+            if (head == m_cachedTail)
+            {
+                m_cachedTail = m_tail.load(std::memory_order_acquire);
+                if (head == m_cachedTail) return false;
+            }
+            item = m_buffer[head & m_mask];
+            m_head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Only safe while no producer is running (e.g. before launching a solve).
+        void clear() noexcept
+        {
+            m_head.store(0, std::memory_order_relaxed);
+            m_tail.store(0, std::memory_order_relaxed);
+            m_cachedHead = 0;
+            m_cachedTail = 0;
+        }
+
+        size_t capacity() const noexcept { return m_buffer.size(); }
+
+    private:
+        static constexpr size_t CacheLine = 64;
+
+        std::vector<T> m_buffer;
+        const size_t m_mask;
+
+        // Consumer owned
+        alignas(CacheLine) std::atomic<size_t> m_head = 0;
+        size_t m_cachedTail = 0;
+
+        // Producer owned
+        alignas(CacheLine) std::atomic<size_t> m_tail = 0;
+        size_t m_cachedHead = 0;
+};
+
+#endif // _RING_BUFFER_H_
@@ -0,0 +1,455 @@
+#include "sectional_loads.h"
+#include "gorilla_codec.h"
+#include "solver_kernel.h"
+#include "util.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+
+namespace
+{
+    constexpr uint32_t FileMagic = 0x534C4350; // "PCLS"
+    constexpr uint32_t FileVersion = 1;
+
+    template<typename T>
+    void writeValue(std::ofstream& file, const T& value)
+    {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template<typename T>
+    void readValue(std::ifstream& file, T& value)
+    {
+        file.read(reinterpret_cast<char*>(&value), sizeof(T));
+    }
+
+    size_t tileCount(size_t count, size_t tile)
+    {
+        return (count + tile - 1) / tile;
+    }
+
+    // Every tile keeps whichever encoding is smaller, tagged by its first byte
+    enum class TileCodec : uint8_t { Gorilla = 0, Residual };
+
+    // Second order prediction on the integer bit patterns with zigzag varint residuals. Spanwise distributions are
+    // smooth, so only a few low mantissa bits are left, where XOR coding would keep the whole noisy mantissa.
+    void encodeResiduals(const std::vector<float>& values, std::vector<uint8_t>& bytes)
+    {
+        uint32_t previous = 0, beforePrevious = 0;
+        for (const float value : values)
+        {
+            const uint32_t bits = std::bit_cast<uint32_t>(value);
+            const uint32_t residual = bits - (2 * previous - beforePrevious);
+            uint32_t zigzag = (residual << 1) ^ static_cast<uint32_t>(static_cast<int32_t>(residual) >> 31);
+            while (zigzag >= 0x80)
+            {
+                bytes.push_back(static_cast<uint8_t>(zigzag) | 0x80);
+                zigzag >>= 7;
+            }
+            bytes.push_back(static_cast<uint8_t>(zigzag));
+            beforePrevious = previous;
+            previous = bits;
+        }
+    }
+
+    std::vector<float> decodeResiduals(const uint8_t* bytes, size_t size, size_t count)
+    {
+        std::vector<float> values(count, 0.0f);
+        uint32_t previous = 0, beforePrevious = 0;
+        size_t position = 0;
+        for (size_t i = 0; i < count && position < size; ++i)
+        {
+            uint32_t zigzag = 0;
+            for (int shift = 0; position < size && shift < 35; shift += 7)
+            {
+                const uint8_t byte = bytes[position++];
+                zigzag |= static_cast<uint32_t>(byte & 0x7F) << shift;
+                if (!(byte & 0x80)) break;
+            }
+            const uint32_t residual = (zigzag >> 1) ^ (0u - (zigzag & 1));
+            const uint32_t bits = residual + (2 * previous - beforePrevious);
+            values[i] = std::bit_cast<float>(bits);
+            beforePrevious = previous;
+            previous = bits;
+        }
+        return values;
+    }
+
+    std::vector<uint8_t> encodeTile(const std::vector<float>& values)
+    {
+        std::vector<uint8_t> residual = {static_cast<uint8_t>(TileCodec::Residual)};
+        encodeResiduals(values, residual);
+
+        // Runs of identical values, such as the forward flow flags, are where XOR coding wins
+        const std::vector<uint8_t> gorilla = GorillaCodec::encode(values);
+        if (gorilla.size() + 1 >= residual.size()) return residual;
+
+        std::vector<uint8_t> bytes = {static_cast<uint8_t>(TileCodec::Gorilla)};
+        bytes.insert(bytes.end(), gorilla.begin(), gorilla.end());
+        return bytes;
+    }
+
+    std::vector<float> decodeTile(const std::vector<uint8_t>& bytes, size_t count)
+    {
+        if (bytes.empty()) return std::vector<float>(count, 0.0f);
+        if (static_cast<TileCodec>(bytes[0]) == TileCodec::Residual) return decodeResiduals(bytes.data() + 1, bytes.size() - 1, count);
+        return GorillaCodec::decode(std::vector<uint8_t>(bytes.begin() + 1, bytes.end()), count);
+    }
+
+    template<typename T>
+    bool parseArgument(const std::string& text, T& value)
+    {
+        std::istringstream stream(text);
+        stream >> value;
+        return !stream.fail() && stream.eof();
+    }
+}
+
+int SectionalLoads::exportMain(const std::vector<std::string>& args)
+{
+    std::string input, output = "sections.csv";
+    size_t channel = static_cast<size_t>(SectionalChannel::Lift), blade = 0, station = 0, first = 0, count = SIZE_MAX;
+    bool slice = false, valid = !args.empty();
+    for (size_t i = 1; i < args.size() && valid; ++i)
+    {
+        const bool hasValue = i + 1 < args.size();
+        if (args[i] == "--channel" && hasValue) valid = parseArgument(args[++i], channel) && channel < ChannelCount;
+        else if (args[i] == "--blade" && hasValue) valid = parseArgument(args[++i], blade);
+        else if (args[i] == "--station" && hasValue) valid = (slice = parseArgument(args[++i], station));
+        else if (args[i] == "--first" && hasValue) valid = parseArgument(args[++i], first);
+        else if (args[i] == "--count" && hasValue) valid = parseArgument(args[++i], count);
+        else if (args[i] == "--output" && hasValue) output = args[++i];
+        else valid = false;
+    }
+
+    if (!valid)
+    {
+        std::cerr << "Usage: solver sections <solution>_sections.bin [--channel c] [--station s [--blade b]] [--first sample] [--count samples]\n"
+                  << "                       [--output file.csv]\n"
+                  << "With --station, the time history of one section, otherwise every section over the samples. Channels:\n";
+        for (size_t c = 0; c < ChannelCount; ++c) std::cerr << "  " << c << ": " << SectionalChannelNames[c] << "\n";
+        return 1;
+    }
+
+    SectionalLoadReader reader;
+    if (!reader.open(args[0])) return 1;
+    std::cout << reader.samples() << " samples, " << reader.blades() << " blades, " << reader.stations() << " stations" << std::endl;
+    if (slice && (blade >= reader.blades() || station >= reader.stations()))
+    {
+        std::cerr << "Blade or station out of range" << std::endl;
+        return 1;
+    }
+
+    const SectionalChannel Channel = static_cast<SectionalChannel>(channel);
+    const bool written = slice ? Util::writeSectionalSliceToCsv(reader, Channel, blade, station, first, count, output)
+                               : Util::writeSectionalWindowToCsv(reader, Channel, first, count, output);
+    return written ? 0 : 1;
+}
+
+void SectionalLoads::evaluate(const BladeGeometry& geometry, float angularPosition, float angularVelocity, float* row)
+{
+    const size_t blades = geometry.offsetCos.size();
+    const size_t stations = geometry.radii.size();
+    const size_t channelSize = blades * stations;
+    float* dynamicPressures = row + static_cast<size_t>(SectionalChannel::DynamicPressure) * channelSize;
+    float* reynoldsNumbers = row + static_cast<size_t>(SectionalChannel::Reynolds) * channelSize;
+    float* forwardFlags = row + static_cast<size_t>(SectionalChannel::Forward) * channelSize;
+    float* lifts = row + static_cast<size_t>(SectionalChannel::Lift) * channelSize;
+    float* drags = row + static_cast<size_t>(SectionalChannel::Drag) * channelSize;
+
+    const float cosTheta = std::cos(angularPosition);
+    const float sinTheta = std::sin(angularPosition);
+
+    for (size_t b = 0; b < blades; ++b)
+    {
+        const float cosPhi = geometry.offsetCos[b] * cosTheta - geometry.offsetSin[b] * sinTheta;
+        const float sinPhi = geometry.offsetSin[b] * cosTheta + geometry.offsetCos[b] * sinTheta;
+        const float freestreamTangential = geometry.freestreamY * cosPhi - geometry.freestreamX * sinPhi;
+
+        for (size_t i = 0; i < stations; ++i)
+        {
+            const size_t index = b * stations + i;
+            const float chord = geometry.chords[i];
+            const float tangentialLocalVelocity = angularVelocity * geometry.radii[i] + freestreamTangential;
+            const float dynamicPressure = 0.5f * geometry.airDensity * tangentialLocalVelocity * tangentialLocalVelocity;
+            const float reynolds = (tangentialLocalVelocity * chord) / geometry.kinematicViscosity;
+            const bool forward = tangentialLocalVelocity > 0;
+
+            float liftCoefficient, dragCoefficient;
+            if (geometry.tabulated)
+            {
+                liftCoefficient = forward ? geometry.liftCoefficients[i] : geometry.reverseLiftCoefficients[i];
+                dragCoefficient = forward ? geometry.dragCoefficients[i] : geometry.reverseDragCoefficients[i];
+            }
+            else
+            {
+                // Polars are tabulated over the magnitude, reversed flow has a negative Reynolds number
+                liftCoefficient = (forward ? geometry.liftPolar : geometry.reverseLiftPolar)->coefficientAt(geometry.pitches[i], std::abs(reynolds));
+                dragCoefficient = (forward ? geometry.dragPolar : geometry.reverseDragPolar)->coefficientAt(geometry.pitches[i], std::abs(reynolds));
+            }
+
+            // Loads per unit span, so they do not depend on the radial quadrature weights
+            dynamicPressures[index] = dynamicPressure;
+            reynoldsNumbers[index] = std::abs(reynolds);
+            forwardFlags[index] = forward ? 1.0f : 0.0f;
+            lifts[index] = dynamicPressure * chord * liftCoefficient;
+            drags[index] = (forward ? -1.0f : 1.0f) * dynamicPressure * chord * dragCoefficient;
+        }
+    }
+}
+
+SectionalLoadWriter::SectionalLoadWriter(const SectionalCaptureSettings& settings) : m_settings(settings)
+{
+    m_settings.decimation = std::max(m_settings.decimation, 1);
+    m_settings.timeTile = std::max(m_settings.timeTile, 1);
+    m_settings.radialTile = std::max(m_settings.radialTile, 1);
+}
+
+SectionalLoadWriter::~SectionalLoadWriter()
+{
+    finish();
+}
+
+bool SectionalLoadWriter::begin(const std::string& solutionName, size_t blades, const std::vector<float>& radii)
+{
+    m_filepath = SectionalLoads::filepath(solutionName);
+    m_file.open(m_filepath, std::ios::binary);
+    if (!m_file.is_open())
+    {
+        std::cerr << "Error opening file for writing: " << m_filepath << std::endl;
+        return false;
+    }
+
+    m_blades = blades;
+    m_stations = radii.size();
+    m_rowSize = SectionalLoads::ChannelCount * m_blades * m_stations;
+    m_rows.assign(m_settings.timeTile * m_rowSize, 0.0f);
+    m_rowCount = 0;
+    m_times.clear();
+    m_tileOffsets.clear();
+    m_tileSizes.clear();
+
+    writeValue(m_file, FileMagic);
+    writeValue(m_file, FileVersion);
+    writeValue(m_file, static_cast<uint32_t>(m_blades));
+    writeValue(m_file, static_cast<uint32_t>(m_stations));
+    writeValue(m_file, static_cast<uint32_t>(SectionalLoads::ChannelCount));
+    writeValue(m_file, static_cast<uint32_t>(m_settings.timeTile));
+    writeValue(m_file, static_cast<uint32_t>(m_settings.radialTile));
+    writeValue(m_file, static_cast<uint32_t>(m_settings.decimation));
+    m_file.write(reinterpret_cast<const char*>(radii.data()), radii.size() * sizeof(float));
+    return static_cast<bool>(m_file);
+}
+
+float* SectionalLoadWriter::append(float time)
+{
+    if (m_rowCount == static_cast<size_t>(m_settings.timeTile)) flushTiles();
+    m_times.push_back(time);
+    return m_rows.data() + (m_rowCount++) * m_rowSize;
+}
+
+void SectionalLoadWriter::flushTiles()
+{
+    if (m_rowCount == 0) return;
+
+    const size_t radialTile = m_settings.radialTile;
+    const size_t channelSize = m_blades * m_stations;
+    std::vector<float> tile;
+    for (size_t firstStation = 0; firstStation < m_stations; firstStation += radialTile)
+    {
+        const size_t lastStation = std::min(firstStation + radialTile, m_stations);
+        for (size_t c = 0; c < SectionalLoads::ChannelCount; ++c)
+        {
+            // Stations vary fastest, loads are much smoother along the span than between decimated time steps
+            tile.clear();
+            for (size_t row = 0; row < m_rowCount; ++row)
+            {
+                const float* channel = m_rows.data() + row * m_rowSize + c * channelSize;
+                for (size_t b = 0; b < m_blades; ++b)
+                {
+                    tile.insert(tile.end(), channel + b * m_stations + firstStation, channel + b * m_stations + lastStation);
+                }
+            }
+
+            const std::vector<uint8_t> bytes = encodeTile(tile);
+            m_tileOffsets.push_back(static_cast<uint64_t>(m_file.tellp()));
+            m_tileSizes.push_back(static_cast<uint32_t>(bytes.size()));
+            m_file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+        }
+    }
+    m_rowCount = 0;
+}
+
+void SectionalLoadWriter::finish()
+{
+    if (!m_file.is_open()) return;
+    flushTiles();
+
+    const uint64_t indexOffset = static_cast<uint64_t>(m_file.tellp());
+    writeValue(m_file, static_cast<uint64_t>(m_times.size()));
+    m_file.write(reinterpret_cast<const char*>(m_times.data()), m_times.size() * sizeof(float));
+    writeValue(m_file, static_cast<uint64_t>(m_tileOffsets.size()));
+    for (size_t t = 0; t < m_tileOffsets.size(); ++t)
+    {
+        writeValue(m_file, m_tileOffsets[t]);
+        writeValue(m_file, m_tileSizes[t]);
+    }
+    writeValue(m_file, indexOffset);
+    writeValue(m_file, FileMagic);
+
+    if (!m_file) std::cerr << "Error writing file: " << m_filepath << std::endl;
+    m_file.close();
+    m_rows = std::vector<float>();
+}
+
+bool SectionalLoadReader::open(const std::string& filepath)
+{
+    m_file = std::ifstream(filepath, std::ios::binary);
+    if (!m_file.is_open())
+    {
+        std::cerr << "Error opening file for reading: " << filepath << std::endl;
+        return false;
+    }
+
+    uint32_t magic = 0, version = 0, blades = 0, stations = 0, channels = 0, timeTile = 0, radialTile = 0, decimation = 0;
+    readValue(m_file, magic);
+    readValue(m_file, version);
+    readValue(m_file, blades);
+    readValue(m_file, stations);
+    readValue(m_file, channels);
+    readValue(m_file, timeTile);
+    readValue(m_file, radialTile);
+    readValue(m_file, decimation);
+    if (!m_file || magic != FileMagic || version != FileVersion || channels != SectionalLoads::ChannelCount || timeTile == 0 || radialTile == 0)
+    {
+        std::cerr << "Not a sectional load file: " << filepath << std::endl;
+        return false;
+    }
+    m_blades = blades;
+    m_timeTile = timeTile;
+    m_radialTile = radialTile;
+    m_radialTiles = tileCount(stations, radialTile);
+    m_radii.resize(stations);
+    m_file.read(reinterpret_cast<char*>(m_radii.data()), stations * sizeof(float));
+
+    // Trailer: index offset and the magic again, missing if the capture never finished
+    uint64_t indexOffset = 0;
+    uint32_t trailerMagic = 0;
+    m_file.seekg(-static_cast<std::streamoff>(sizeof(uint64_t) + sizeof(uint32_t)), std::ios::end);
+    readValue(m_file, indexOffset);
+    readValue(m_file, trailerMagic);
+    if (!m_file || trailerMagic != FileMagic)
+    {
+        std::cerr << "Incomplete sectional load file: " << filepath << std::endl;
+        return false;
+    }
+
+    uint64_t samples = 0, tiles = 0;
+    m_file.seekg(indexOffset);
+    readValue(m_file, samples);
+    m_times.resize(samples);
+    m_file.read(reinterpret_cast<char*>(m_times.data()), samples * sizeof(float));
+    readValue(m_file, tiles);
+    if (!m_file || tiles != tileCount(samples, m_timeTile) * m_radialTiles * SectionalLoads::ChannelCount)
+    {
+        std::cerr << "Corrupt sectional load file: " << filepath << std::endl;
+        return false;
+    }
+
+    m_tileOffsets.resize(tiles);
+    m_tileSizes.resize(tiles);
+    for (size_t t = 0; t < tiles; ++t)
+    {
+        readValue(m_file, m_tileOffsets[t]);
+        readValue(m_file, m_tileSizes[t]);
+    }
+    m_tilesDecoded = 0;
+
+    if (!m_file)
+    {
+        std::cerr << "Error reading file: " << filepath << std::endl;
+        return false;
+    }
+    return true;
+}
+
+size_t SectionalLoadReader::tileStations(size_t radialTile) const
+{
+    return std::min(m_radialTile, m_radii.size() - radialTile * m_radialTile);
+}
+
+size_t SectionalLoadReader::tileSamples(size_t timeTile) const
+{
+    return std::min(m_timeTile, m_times.size() - timeTile * m_timeTile);
+}
+
+std::vector<float> SectionalLoadReader::readTile(size_t timeTile, size_t radialTile, SectionalChannel channel)
+{
+    const size_t index = (timeTile * m_radialTiles + radialTile) * SectionalLoads::ChannelCount + static_cast<size_t>(channel);
+    std::vector<uint8_t> bytes(m_tileSizes[index]);
+    m_file.clear();
+    m_file.seekg(m_tileOffsets[index]);
+    m_file.read(reinterpret_cast<char*>(bytes.data()), bytes.size());
+
+    ++m_tilesDecoded;
+    return decodeTile(bytes, m_blades * tileStations(radialTile) * tileSamples(timeTile));
+}
+
+std::vector<float> SectionalLoadReader::radialSlice(SectionalChannel channel, size_t blade, size_t station, size_t first, size_t count)
+{
+    std::vector<float> slice;
+    if (blade >= m_blades || station >= m_radii.size() || first >= m_times.size()) return slice;
+    const size_t last = first + std::min(count, m_times.size() - first);
+
+    // Only the column of tiles holding the station, over the requested time range
+    const size_t radialTile = station / m_radialTile;
+    const size_t stationInTile = station % m_radialTile;
+    const size_t stationsInTile = tileStations(radialTile);
+    for (size_t timeTile = first / m_timeTile; timeTile * m_timeTile < last; ++timeTile)
+    {
+        const std::vector<float> tile = readTile(timeTile, radialTile, channel);
+        const size_t samplesInTile = tileSamples(timeTile);
+        const size_t tileFirst = timeTile * m_timeTile;
+        for (size_t s = std::max(first, tileFirst); s < std::min(last, tileFirst + samplesInTile); ++s)
+        {
+            slice.push_back(tile[((s - tileFirst) * m_blades + blade) * stationsInTile + stationInTile]);
+        }
+    }
+    return slice;
+}
+
+std::vector<float> SectionalLoadReader::timeWindow(SectionalChannel channel, size_t first, size_t count)
+{
+    std::vector<float> window;
+    if (first >= m_times.size()) return window;
+    const size_t last = first + std::min(count, m_times.size() - first);
+    const size_t stations = m_radii.size();
+    window.resize((last - first) * m_blades * stations);
+
+    // Every radial tile, but only the time tiles overlapping the window
+    for (size_t timeTile = first / m_timeTile; timeTile * m_timeTile < last; ++timeTile)
+    {
+        const size_t samplesInTile = tileSamples(timeTile);
+        const size_t tileFirst = timeTile * m_timeTile;
+        const size_t begin = std::max(first, tileFirst);
+        const size_t end = std::min(last, tileFirst + samplesInTile);
+
+        for (size_t radialTile = 0; radialTile < m_radialTiles; ++radialTile)
+        {
+            const std::vector<float> tile = readTile(timeTile, radialTile, channel);
+            const size_t stationsInTile = tileStations(radialTile);
+            for (size_t s = begin; s < end; ++s)
+            {
+                for (size_t b = 0; b < m_blades; ++b)
+                {
+                    const float* source = tile.data() + ((s - tileFirst) * m_blades + b) * stationsInTile;
+                    std::copy(source, source + stationsInTile, window.begin() + ((s - first) * m_blades + b) * stations + radialTile * m_radialTile);
+                }
+            }
+        }
+    }
+    return window;
+}
@@ -0,0 +1,121 @@
+#ifndef _SECTIONAL_LOADS_H_
+#define _SECTIONAL_LOADS_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+struct BladeGeometry;
+
+// Per section quantities a capture records, indexed by (time, blade, radial station)
+enum class SectionalChannel : size_t { DynamicPressure = 0, Reynolds, Forward, Lift, Drag, Count };
+inline constexpr std::array<const char*, static_cast<size_t>(SectionalChannel::Count)> SectionalChannelNames = {
+    "Dynamic Pressure (Pa)", "Reynolds Number", "Forward Flow", "Section Lift (N/m)", "Section Drag (N/m)"
+};
+
+struct SectionalCaptureSettings
+{
+    // Every decimation-th time step is captured
+    int decimation = 10;
+
+    // Captured steps and radial stations per tile, tiles are the unit of compression and of reading
+    int timeTile = 256;
+    int radialTile = 32;
+};
+
+namespace SectionalLoads
+{
+    constexpr size_t ChannelCount = static_cast<size_t>(SectionalChannel::Count);
+
+    // Capture file of a solution, next to its CSV export
+    inline std::string filepath(const std::string& solutionName) { return solutionName + "_sections.bin"; }
+
+    // Headless export of a capture to CSV, either one section's time history or every section over a window
+    int exportMain(const std::vector<std::string>& args);
+
+    // Fills row, laid out [channel][blade][station], with the section loads at one instant.
+    // Same arithmetic as the solver kernels. Lift and Drag are per unit span, Drag is the signed tangential
+    // force (positive drives the rotor) and Reynolds is the magnitude.
+    void evaluate(const BladeGeometry& geometry, float angularPosition, float angularVelocity, float* row);
+}
+
+// Streams captured time steps to disk one row of tiles at a time, so the full field is never held in memory.
+// Within a tile each channel is compressed separately, stations varying fastest, with either integer residuals
+// or GorillaCodec, whichever is smaller. An index of every tile is written when the capture finishes.
+class SectionalLoadWriter
+{
+    public:
+        explicit SectionalLoadWriter(const SectionalCaptureSettings& settings);
+        ~SectionalLoadWriter();
+
+        SectionalLoadWriter(const SectionalLoadWriter&) = delete;
+        SectionalLoadWriter& operator=(const SectionalLoadWriter&) = delete;
+
+        // Opens the capture file of the named solution, false if it cannot be written
+        bool begin(const std::string& solutionName, size_t blades, const std::vector<float>& radii);
+
+        // Row to fill for a captured step at time, see SectionalLoads::evaluate for the layout
+        float* append(float time);
+
+        // Flushes the last partial tiles and writes the index
+        void finish();
+
+        int decimation() const { return m_settings.decimation; }
+        const std::string& filepath() const { return m_filepath; }
+
+    private:
+        void flushTiles();
+
+        SectionalCaptureSettings m_settings;
+        std::string m_filepath;
+        std::ofstream m_file;
+        size_t m_blades = 0, m_stations = 0, m_rowSize = 0;
+
+        // Current row of tiles, [row][channel][blade][station]
+        std::vector<float> m_rows;
+        size_t m_rowCount = 0;
+
+        std::vector<float> m_times;
+        std::vector<uint64_t> m_tileOffsets;
+        std::vector<uint32_t> m_tileSizes;
+};
+
+// Random access to a capture. Only the tiles a query touches are read and decompressed.
+class SectionalLoadReader
+{
+    public:
+        bool open(const std::string& filepath);
+
+        size_t samples() const { return m_times.size(); }
+        size_t blades() const { return m_blades; }
+        size_t stations() const { return m_radii.size(); }
+        const std::vector<float>& times() const { return m_times; }
+        const std::vector<float>& radii() const { return m_radii; }
+
+        // Time history of one channel at one blade section over the captured samples [first, first + count)
+        std::vector<float> radialSlice(SectionalChannel channel, size_t blade, size_t station, size_t first = 0, size_t count = SIZE_MAX);
+
+        // Every blade and station of one channel over [first, first + count), laid out [sample][blade][station]
+        std::vector<float> timeWindow(SectionalChannel channel, size_t first, size_t count);
+
+        // Tiles decompressed by queries so far
+        size_t tilesDecoded() const { return m_tilesDecoded; }
+
+    private:
+        // Decompressed tile, [sample in tile][blade][station in tile]
+        std::vector<float> readTile(size_t timeTile, size_t radialTile, SectionalChannel channel);
+        size_t tileStations(size_t radialTile) const;
+        size_t tileSamples(size_t timeTile) const;
+
+        std::ifstream m_file;
+        size_t m_blades = 0, m_timeTile = 0, m_radialTile = 0, m_radialTiles = 0;
+        std::vector<float> m_radii, m_times;
+        std::vector<uint64_t> m_tileOffsets;
+        std::vector<uint32_t> m_tileSizes;
+        size_t m_tilesDecoded = 0;
+};
+
+#endif // _SECTIONAL_LOADS_H_
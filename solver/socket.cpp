@@ -0,0 +1,282 @@
+#include "socket.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#include <ws2tcpip.h>
+#include <afunix.h>
+#else
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+#ifdef _WIN32
+    struct WinsockSession
+    {
+        WinsockSession() { WSADATA data; WSAStartup(MAKEWORD(2, 2), &data); }
+        ~WinsockSession() { WSACleanup(); }
+    };
+    const WinsockSession Winsock;
+
+    constexpr int SendFlags = 0;
+
+    void closeHandle(Socket::Handle handle) { closesocket(handle); }
+
+    bool interrupted() { return false; }
+#else
+    // A vanished worker must show up as a failed send, not a SIGPIPE that kills the coordinator
+#ifdef MSG_NOSIGNAL
+    constexpr int SendFlags = MSG_NOSIGNAL;
+#else
+    constexpr int SendFlags = 0;
+#endif
+
+    void closeHandle(Socket::Handle handle) { ::close(handle); }
+
+    // A signal arriving during a blocking call, the call is simply repeated
+    bool interrupted() { return errno == EINTR; }
+#endif
+
+    // The unix: path may name anything, only socket files are ever unlinked
+    bool isSocketFile(const std::string& path)
+    {
+#ifdef _WIN32
+        // AF_UNIX socket files are reparse points on Windows
+        const DWORD attributes = GetFileAttributesA(path.c_str());
+        return attributes != INVALID_FILE_ATTRIBUTES && (attributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0;
+#else
+        struct stat status;
+        return lstat(path.c_str(), &status) == 0 && S_ISSOCK(status.st_mode);
+#endif
+    }
+
+    struct Endpoint
+    {
+        bool local = false; // Unix-domain
+        std::string host, port, path;
+    };
+
+    bool parseAddress(const std::string& address, Endpoint& endpoint)
+    {
+        if (address.rfind("unix:", 0) == 0)
+        {
+            endpoint.local = true;
+            endpoint.path = address.substr(5);
+            return !endpoint.path.empty() && endpoint.path.size() < sizeof(sockaddr_un::sun_path);
+        }
+        if (address.rfind("tcp:", 0) == 0)
+        {
+            const std::string rest = address.substr(4);
+            const size_t colon = rest.rfind(':');
+            if (colon == std::string::npos) return false;
+            endpoint.host = rest.substr(0, colon);
+            endpoint.port = rest.substr(colon + 1);
+            return !endpoint.port.empty();
+        }
+        return false;
+    }
+
+    sockaddr_un unixAddress(const std::string& path)
+    {
+        sockaddr_un address = {};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+        return address;
+    }
+
+    // Resolves the TCP endpoint and calls attempt on each candidate until one succeeds
+    template<typename Function>
+    Socket::Handle withTcpAddresses(const Endpoint& endpoint, bool passive, Function&& attempt)
+    {
+        addrinfo hints = {};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_flags = passive ? AI_PASSIVE : 0;
+
+        addrinfo* results = nullptr;
+        if (getaddrinfo(endpoint.host.empty() ? nullptr : endpoint.host.c_str(), endpoint.port.c_str(), &hints, &results) != 0)
+            return Socket::InvalidHandle;
+
+        Socket::Handle handle = Socket::InvalidHandle;
+        for (addrinfo* candidate = results; candidate && handle == Socket::InvalidHandle; candidate = candidate->ai_next)
+        {
+            handle = socket(candidate->ai_family, candidate->ai_socktype, candidate->ai_protocol);
+            if (handle == Socket::InvalidHandle) continue;
+            if (!attempt(handle, candidate->ai_addr, static_cast<int>(candidate->ai_addrlen)))
+            {
+                closeHandle(handle);
+                handle = Socket::InvalidHandle;
+            }
+        }
+        freeaddrinfo(results);
+        return handle;
+    }
+}
+
+Socket::~Socket()
+{
+    close();
+}
+
+Socket::Socket(Socket&& other) noexcept : m_handle(other.m_handle), m_unixPath(std::move(other.m_unixPath))
+{
+    other.m_handle = InvalidHandle;
+    other.m_unixPath.clear();
+}
+
+Socket& Socket::operator=(Socket&& other) noexcept
+{
+    if (this != &other)
+    {
+        close();
+        m_handle = other.m_handle;
+        m_unixPath = std::move(other.m_unixPath);
+        other.m_handle = InvalidHandle;
+        other.m_unixPath.clear();
+    }
+    return *this;
+}
+
+Socket Socket::listen(const std::string& address)
+{
+    Endpoint endpoint;
+    if (!parseAddress(address, endpoint))
+    {
+        std::cerr << "Invalid socket address: " << address << std::endl;
+        return Socket();
+    }
+
+    Socket result;
+    if (endpoint.local)
+    {
+        // A stale socket file from an earlier run would make bind fail, anything else there makes it fail on purpose
+        if (isSocketFile(endpoint.path)) std::remove(endpoint.path.c_str());
+        const sockaddr_un unixEndpoint = unixAddress(endpoint.path);
+
+        Handle handle = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (handle != InvalidHandle && bind(handle, reinterpret_cast<const sockaddr*>(&unixEndpoint), sizeof(unixEndpoint)) != 0)
+        {
+            closeHandle(handle);
+            handle = InvalidHandle;
+        }
+        result = Socket(handle);
+        if (result.valid()) result.m_unixPath = endpoint.path;
+    }
+    else
+    {
+        result = Socket(withTcpAddresses(endpoint, true, [](Handle handle, const sockaddr* address, int length) {
+            const int reuse = 1;
+            setsockopt(handle, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+            return bind(handle, address, length) == 0;
+        }));
+    }
+
+    if (!result.valid() || ::listen(result.m_handle, SOMAXCONN) != 0)
+    {
+        std::cerr << "Error listening on: " << address << std::endl;
+        return Socket();
+    }
+    return result;
+}
+
+Socket Socket::connect(const std::string& address)
+{
+    Endpoint endpoint;
+    if (!parseAddress(address, endpoint))
+    {
+        std::cerr << "Invalid socket address: " << address << std::endl;
+        return Socket();
+    }
+
+    if (endpoint.local)
+    {
+        const sockaddr_un unixEndpoint = unixAddress(endpoint.path);
+        Handle handle = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (handle != InvalidHandle && ::connect(handle, reinterpret_cast<const sockaddr*>(&unixEndpoint), sizeof(unixEndpoint)) != 0)
+        {
+            closeHandle(handle);
+            handle = InvalidHandle;
+        }
+        return Socket(handle);
+    }
+
+    return Socket(withTcpAddresses(endpoint, false, [](Handle handle, const sockaddr* address, int length) {
+        return ::connect(handle, address, length) == 0;
+    }));
+}
+
+Socket Socket::accept() const
+{
+    return Socket(::accept(m_handle, nullptr, nullptr));
+}
+
+bool Socket::sendAll(const void* data, size_t size) const
+{
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0)
+    {
+        const long sent = send(m_handle, bytes, static_cast<int>(size), SendFlags);
+        if (sent < 0 && interrupted()) continue;
+        if (sent <= 0) return false;
+        bytes += sent;
+        size -= sent;
+    }
+    return true;
+}
+
+long Socket::receiveSome(std::vector<uint8_t>& buffer) const
+{
+    char chunk[4096];
+    long received = recv(m_handle, chunk, sizeof(chunk), 0);
+    while (received < 0 && interrupted()) received = recv(m_handle, chunk, sizeof(chunk), 0);
+    if (received > 0) buffer.insert(buffer.end(), chunk, chunk + received);
+    return received < 0 ? -1 : received;
+}
+
+bool Socket::poll(const std::vector<const Socket*>& sockets, int timeoutMs, std::vector<bool>& readable)
+{
+    std::vector<pollfd> descriptors(sockets.size());
+    for (size_t i = 0; i < sockets.size(); ++i)
+    {
+        descriptors[i].fd = sockets[i]->m_handle;
+        descriptors[i].events = POLLIN;
+    }
+
+    int ready = 0;
+    do
+    {
+#ifdef _WIN32
+        ready = WSAPoll(descriptors.data(), static_cast<ULONG>(descriptors.size()), timeoutMs);
+#else
+        ready = ::poll(descriptors.data(), descriptors.size(), timeoutMs);
+#endif
+    } while (ready < 0 && interrupted());
+
+    readable.assign(sockets.size(), false);
+    if (ready < 0) return false;
+
+    // Hang-ups and errors count as readable so the next receive reports them
+    for (size_t i = 0; i < sockets.size(); ++i) readable[i] = descriptors[i].revents != 0;
+    return true;
+}
+
+void Socket::close()
+{
+    if (m_handle == InvalidHandle) return;
+    closeHandle(m_handle);
+    m_handle = InvalidHandle;
+
+    if (!m_unixPath.empty())
+    {
+        std::remove(m_unixPath.c_str());
+        m_unixPath.clear();
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef _SOCKET_H_
+#define _SOCKET_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#else
+#include <poll.h>
+#endif
+
+// Minimal blocking stream socket over TCP or Unix-domain sockets.
+// Addresses are "tcp:host:port" (host may be empty to listen on every interface) or "unix:path".
+class Socket
+{
+    public:
+#ifdef _WIN32
+        using Handle = SOCKET;
+        static constexpr Handle InvalidHandle = INVALID_SOCKET;
+#else
+        using Handle = int;
+        static constexpr Handle InvalidHandle = -1;
+#endif
+
+        Socket() {}
+        explicit Socket(Handle handle) : m_handle(handle) {}
+        ~Socket();
+
+        Socket(Socket&& other) noexcept;
+        Socket& operator=(Socket&& other) noexcept;
+        Socket(const Socket&) = delete;
+        Socket& operator=(const Socket&) = delete;
+
+        // Both return an invalid socket and print the reason on failure
+        static Socket listen(const std::string& address);
+        static Socket connect(const std::string& address);
+
+        Socket accept() const;
+
+        // Sends every byte, false once the peer is gone
+        bool sendAll(const void* data, size_t size) const;
+
+        // Appends whatever is available without waiting for more, 0 once the peer has closed, -1 on error
+        long receiveSome(std::vector<uint8_t>& buffer) const;
+
+        // Waits up to timeoutMs for any of the sockets to become readable, readable[i] is set per socket
+        static bool poll(const std::vector<const Socket*>& sockets, int timeoutMs, std::vector<bool>& readable);
+
+        bool valid() const { return m_handle != InvalidHandle; }
+        void close();
+
+    private:
+        Handle m_handle = InvalidHandle;
+        std::string m_unixPath; // Removed again when a listening Unix-domain socket closes
+};
+
+#endif // _SOCKET_H_
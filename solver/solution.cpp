@@ -1,7 +1,12 @@
 #include "solution.h"
 #include "util.h"
 
-size_t Solution::solutionNumber = 0;
+#include <ctime>
+#include <functional>
+#include <random>
+#include <thread>
+
+std::atomic<size_t> Solution::solutionNumber = 0;
 
 Solution::Solution(size_t size) : time(size, 0.0f), 
     angularPosition(size, 0.0f), 
@@ -12,38 +17,93 @@ Solution::Solution(size_t size) : time(size, 0.0f),
     drag(size, 0.0f), 
     sideForce(size, 0.0f) 
 {
-    name = "solution_" + std::to_string(solutionNumber);
-    solutionNumber++;
-
-    // Ensure random seed is initialized
-    static bool seedInitialized = false;
-    if (!seedInitialized) {
-        std::srand(static_cast<unsigned>(std::time(nullptr)));
-        seedInitialized = true;
+    identify();
+}
+
+void Solution::reset(size_t size) {
+    resize(size);
+    spectrum = SpectralAnalysis();
+    cycles = CycleStatistics();
+    identify();
+}
+
+void Solution::resize(size_t size) {
+    for (std::vector<float>* column : {&time, &angularPosition, &angularVelocity, &angularAcceleration, &torque, &lift, &drag, &sideForce}) {
+        column->resize(size);
     }
+}
+
+void Solution::identify() {
+    // Sweeps solve on many threads at once, names must stay unique (SolutionStore spills under them)
+    name = "solution_" + std::to_string(solutionNumber.fetch_add(1, std::memory_order_relaxed));
+
+    // One generator per thread, std::rand is not thread safe
+    thread_local std::minstd_rand generator(static_cast<unsigned>(std::time(nullptr)) ^ static_cast<unsigned>(std::hash<std::thread::id>()(std::this_thread::get_id())));
+    std::uniform_int_distribution<int> channel(100, 255);
 
     // Generate vibrant random color
-    float r = (std::rand() % 156 + 100) / 255.0f; // Between 100-255
-    float g = (std::rand() % 156 + 100) / 255.0f; // Between 100-255
-    float b = (std::rand() % 156 + 100) / 255.0f; // Between 100-255
+    float r = channel(generator) / 255.0f; // Between 100-255
+    float g = channel(generator) / 255.0f; // Between 100-255
+    float b = channel(generator) / 255.0f; // Between 100-255
 
     color = ImVec4(r, g, b, 1.0f);
 }
 
-void Solution::clean() {
-    if (time.size() > 1000) {
-        size_t windowSize = time.size() / 1000;
-        downsample(windowSize);
+const std::vector<float>& Solution::field(Field field) const {
+    switch (field) {
+        case Field::AngularPosition:     return angularPosition;
+        case Field::AngularVelocity:     return angularVelocity;
+        case Field::AngularAcceleration: return angularAcceleration;
+        case Field::Torque:              return torque;
+        case Field::Lift:                return lift;
+        case Field::Drag:                return drag;
+        default:                         return sideForce;
     }
 }
 
-void Solution::downsample(const size_t& windowSize) {
-    time                = Util::downsampleMinmax(time, windowSize);
-    angularPosition     = Util::downsampleMinmax(angularPosition, windowSize);
-    angularVelocity     = Util::downsampleMinmax(angularVelocity, windowSize);
-    angularAcceleration = Util::downsampleMinmax(angularAcceleration, windowSize);
-    torque              = Util::downsampleMinmax(torque, windowSize);
-    lift                = Util::downsampleMinmax(lift, windowSize);
-    drag                = Util::downsampleMinmax(drag, windowSize);
-    sideForce           = Util::downsampleMinmax(sideForce, windowSize);
+MinMaxPyramid::View Solution::view(Field field, double timeMin, double timeMax, float pixels) const {
+    return pyramid.view(time, this->field(field), static_cast<size_t>(field), timeMin, timeMax, pixels);
+}
+
+void Solution::clean() {
+    pyramid.build(time, {&angularPosition, &angularVelocity, &angularAcceleration, &torque, &lift, &drag, &sideForce});
+}
+
+void Solution::append(const SolutionSample& sample) {
+    time.push_back(sample.time);
+    angularPosition.push_back(sample.angularPosition);
+    angularVelocity.push_back(sample.angularVelocity);
+    angularAcceleration.push_back(sample.angularAcceleration);
+    torque.push_back(sample.torque);
+    lift.push_back(sample.lift);
+    drag.push_back(sample.drag);
+    sideForce.push_back(sample.sideForce);
+}
+
+SteadyState Solution::steadyState(float window) const {
+    SteadyState state;
+    if (time.empty()) return state;
+
+    const size_t count = std::clamp<size_t>(static_cast<size_t>(time.size() * window), 1, time.size());
+    const size_t begin = time.size() - count;
+
+    const float motorDamping = configuration.motorDamping();
+
+    double sums[6] = {0, 0, 0, 0, 0, 0};
+    for (size_t t = begin; t < time.size(); ++t) {
+        sums[0] += angularVelocity[t];
+        sums[1] += torque[t];
+        sums[2] += lift[t];
+        sums[3] += drag[t];
+        sums[4] += sideForce[t];
+        sums[5] += torque[t] + angularVelocity[t] * motorDamping;
+    }
+
+    state.angularVelocity = static_cast<float>(sums[0] / count);
+    state.torque          = static_cast<float>(sums[1] / count);
+    state.lift            = static_cast<float>(sums[2] / count);
+    state.drag            = static_cast<float>(sums[3] / count);
+    state.sideForce       = static_cast<float>(sums[4] / count);
+    state.aerodynamicTorque = static_cast<float>(sums[5] / count);
+    return state;
 }
\ No newline at end of file
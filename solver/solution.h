@@ -1,11 +1,28 @@
 #ifndef _SOLUTION_H_
 #define _SOLUTION_H_
 
+#include <atomic>
 #include <vector>
 #include <mutex>
 
 #include "configuration.h"
+#include "cycle_statistics.h"
 #include "imgui.h"
+#include "minmax_pyramid.h"
+#include "spectral.h"
+
+// A single time step of a Solution, used to stream results out of a running solve
+struct SolutionSample {
+    float time, angularPosition, angularVelocity, angularAcceleration, torque, lift, drag, sideForce;
+};
+
+// Means over the tail of a solve, once the transient has died out
+struct SteadyState {
+    float angularVelocity = 0, torque = 0, lift = 0, drag = 0, sideForce = 0;
+
+    // Net torque plus the motor back-EMF term, the torque the rotor delivers to the motor
+    float aerodynamicTorque = 0;
+};
 
 struct Solution {
     public:
@@ -14,27 +31,44 @@ struct Solution {
 
         explicit Solution(size_t size);
 
-        // Getters for function pointers in PlotConfiguration
-        const std::vector<float>& getTime() const { return time; }
-        const std::vector<float>& getAngularPosition() const { return angularPosition; }
-        const std::vector<float>& getAngularVelocity() const { return angularVelocity; }
-        const std::vector<float>& getAngularAcceleration() const { return angularAcceleration; }
-        const std::vector<float>& getTorque() const { return torque; }
-        const std::vector<float>& getLift() const { return lift; }
-        const std::vector<float>& getDrag() const { return drag; }
-        const std::vector<float>& getSideForce() const { return sideForce; }
+        // Reuses the storage for a new solution of size steps under a new name. Columns keep whatever they held,
+        // so only callers that overwrite every step (Solver::solve) should skip zeroing them.
+        void reset(size_t size);
+
+        // Resizes every column, keeping the steps both sizes share
+        void resize(size_t size);
+
+        // Plottable columns, in the order they are stored in the pyramid
+        enum class Field : size_t { AngularPosition = 0, AngularVelocity, AngularAcceleration, Torque, Lift, Drag, SideForce, Count };
+
+        const std::vector<float>& field(Field field) const;
+
+        // Level-of-detail view of a field over a visible time range, about two points per pixel
+        MinMaxPyramid::View view(Field field, double timeMin, double timeMax, float pixels) const;
 
     public:
         std::vector<float> time, angularPosition, angularVelocity, angularAcceleration, torque, lift, drag, sideForce;
         Configuration configuration;
         std::string name;
         ImVec4 color;
+        MinMaxPyramid pyramid;
 
+        // Computed at full time resolution during the solve, clean() decimation would lose it
+        SpectralAnalysis spectrum;
+
+        // Per revolution statistics, also computed at full time resolution during the solve
+        CycleStatistics cycles;
+
+        // Builds the level-of-detail pyramid, the full resolution data is kept
         void clean();
+        void append(const SolutionSample& sample);
+
+        // Averages over the last window fraction of the simulated time
+        SteadyState steadyState(float window = 0.1f) const;
 
     private:
-        void downsample(const size_t& windowSize);
+        void identify();
 
-        static size_t solutionNumber;
+        static std::atomic<size_t> solutionNumber;
 };
 #endif //_SOLUTION_H_
\ No newline at end of file
@@ -0,0 +1,46 @@
+#include "solution_pool.h"
+
+Solution SolutionPool::acquire(size_t size)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    ++m_statistics.acquired;
+    if (m_free.empty())
+    {
+        ++m_statistics.allocated;
+        lock.unlock();
+        return Solution(size);
+    }
+
+    // Prefer a solution that already fits, the columns of any other would be reallocated
+    size_t best = m_free.size() - 1;
+    for (size_t i = 0; i < m_free.size(); ++i)
+    {
+        if (m_free[i].time.capacity() >= size)
+        {
+            best = i;
+            break;
+        }
+    }
+    const bool fits = m_free[best].time.capacity() >= size;
+    ++(fits ? m_statistics.reused : m_statistics.allocated);
+
+    std::swap(m_free[best], m_free.back());
+    Solution solution = std::move(m_free.back());
+    m_free.pop_back();
+    lock.unlock();
+
+    solution.reset(size);
+    return solution;
+}
+
+void SolutionPool::release(Solution&& solution)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_free.size() < m_capacity) m_free.push_back(std::move(solution));
+}
+
+SolutionPool::Statistics SolutionPool::statistics() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_statistics;
+}
@@ -0,0 +1,43 @@
+#ifndef _SOLUTION_POOL_H_
+#define _SOLUTION_POOL_H_
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+#include "solution.h"
+
+// Recycles whole solutions between runs. A released solution keeps the capacity of its columns and pyramid levels,
+// so sweeps of thousands of same-length solves stop allocating, zero filling and freeing them on every run.
+// Safe to share between the threads of a sweep.
+class SolutionPool
+{
+    public:
+        struct Statistics
+        {
+            size_t acquired = 0;
+
+            // Acquisitions served by a released solution without growing its columns
+            size_t reused = 0;
+
+            // Solutions constructed, or recycled ones whose columns had to grow
+            size_t allocated = 0;
+        };
+
+        // Solutions beyond this many are freed on release rather than kept
+        explicit SolutionPool(size_t capacity = 64) : m_capacity(capacity) {}
+
+        // A solution of size steps with a new name. Recycled columns are not zeroed, see Solution::reset.
+        Solution acquire(size_t size);
+        void release(Solution&& solution);
+
+        Statistics statistics() const;
+
+    private:
+        size_t m_capacity;
+        std::vector<Solution> m_free;
+        Statistics m_statistics;
+        mutable std::mutex m_mutex;
+};
+
+#endif // _SOLUTION_POOL_H_
@@ -0,0 +1,221 @@
+#include "solution_store.h"
+#include "gorilla_codec.h"
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace
+{
+    int processId()
+    {
+#ifdef _WIN32
+        return _getpid();
+#else
+        return static_cast<int>(getpid());
+#endif
+    }
+}
+
+SolutionStore::SolutionStore(size_t memoryBudget, const std::string& spillDirectory)
+    : m_memoryBudget(memoryBudget), m_spillDirectory(spillDirectory)
+{
+    if (m_spillDirectory.empty())
+    {
+        static std::atomic<unsigned> stores = 0;
+        std::error_code error;
+        const std::filesystem::path temporary = std::filesystem::temp_directory_path(error);
+        const std::string name = "solver-spill-" + std::to_string(processId()) + "-" + std::to_string(stores++);
+        m_spillDirectory = ((error ? std::filesystem::path("spill") : temporary) / name).string();
+        m_ownsSpillDirectory = true;
+    }
+}
+
+SolutionStore::~SolutionStore()
+{
+    std::error_code error;
+    for (const Entry& entry : m_entries)
+    {
+        if (!entry.spillPath.empty()) std::filesystem::remove(entry.spillPath, error);
+    }
+    // Only succeeds once empty, whatever else ended up in there is left alone
+    if (m_ownsSpillDirectory) std::filesystem::remove(m_spillDirectory, error);
+}
+
+void SolutionStore::add(Solution&& solution)
+{
+    Entry entry;
+    entry.name = solution.name;
+    entry.color = solution.color;
+    entry.configuration = solution.configuration;
+    entry.spectrum = solution.spectrum;
+    entry.cycles = solution.cycles;
+    entry.samples = solution.time.size();
+    entry.solution = std::make_unique<Solution>(std::move(solution));
+
+    m_entries.push_back(std::move(entry));
+    touch(m_entries.size() - 1);
+}
+
+const Solution* SolutionStore::get(size_t index)
+{
+    Entry& entry = m_entries[index];
+    if (!entry.error.empty()) return nullptr;
+    if (!entry.solution && !decompress(entry)) return nullptr;
+    touch(index);
+    return entry.solution.get();
+}
+
+std::array<std::vector<float>*, SolutionStore::ColumnCount> SolutionStore::columnsOf(Solution& solution)
+{
+    return {&solution.time, &solution.angularPosition, &solution.angularVelocity, &solution.angularAcceleration,
+            &solution.torque, &solution.lift, &solution.drag, &solution.sideForce};
+}
+
+void SolutionStore::touch(size_t index)
+{
+    m_entries[index].lastUsed = ++m_clock;
+
+    auto it = std::find(m_decompressed.begin(), m_decompressed.end(), index);
+    if (it != m_decompressed.end()) m_decompressed.erase(it);
+    m_decompressed.push_front(index);
+
+    while (m_decompressed.size() > DecompressedCacheSize)
+    {
+        compress(m_entries[m_decompressed.back()]);
+        m_decompressed.pop_back();
+    }
+
+    enforceBudget();
+}
+
+void SolutionStore::compress(Entry& entry)
+{
+    // Solutions never change once stored, so the columns only have to be encoded once
+    if (!entry.compressed)
+    {
+        const auto columns = columnsOf(*entry.solution);
+        for (size_t c = 0; c < ColumnCount; ++c)
+        {
+            entry.columns[c] = GorillaCodec::encode(*columns[c]);
+            m_compressedBytes += entry.columns[c].size();
+        }
+        entry.compressed = true;
+    }
+    entry.solution.reset();
+}
+
+bool SolutionStore::decompress(Entry& entry)
+{
+    if (!entry.spillPath.empty() && !unspill(entry))
+    {
+        entry.error = "Solution data could not be reloaded from " + entry.spillPath;
+        return false;
+    }
+
+    entry.solution = std::make_unique<Solution>();
+    Solution& solution = *entry.solution;
+    solution.name = entry.name;
+    solution.color = entry.color;
+    solution.configuration = entry.configuration;
+    solution.spectrum = entry.spectrum;
+    solution.cycles = entry.cycles;
+
+    const auto columns = columnsOf(solution);
+    for (size_t c = 0; c < ColumnCount; ++c)
+    {
+        *columns[c] = GorillaCodec::decode(entry.columns[c], entry.samples);
+    }
+    solution.clean();
+    return true;
+}
+
+bool SolutionStore::spill(Entry& entry)
+{
+    std::error_code error;
+    std::filesystem::create_directories(m_spillDirectory, error);
+
+    // Named by position, solution names need not be unique
+    const size_t index = static_cast<size_t>(&entry - m_entries.data());
+    const std::string path = (std::filesystem::path(m_spillDirectory) / ("solution_" + std::to_string(index) + ".bin")).string();
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open())
+    {
+        std::cerr << "Error opening file for writing: " << path << std::endl;
+        return false;
+    }
+
+    for (const std::vector<uint8_t>& column : entry.columns)
+    {
+        const uint64_t size = column.size();
+        file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        file.write(reinterpret_cast<const char*>(column.data()), size);
+    }
+    if (!file)
+    {
+        std::cerr << "Error writing file: " << path << std::endl;
+        return false;
+    }
+
+    for (std::vector<uint8_t>& column : entry.columns)
+    {
+        m_compressedBytes -= column.size();
+        std::vector<uint8_t>().swap(column);
+    }
+    entry.spillPath = path;
+    return true;
+}
+
+bool SolutionStore::unspill(Entry& entry)
+{
+    std::ifstream file(entry.spillPath, std::ios::binary);
+    if (!file.is_open())
+    {
+        std::cerr << "Error opening file for reading: " << entry.spillPath << std::endl;
+        return false;
+    }
+
+    for (std::vector<uint8_t>& column : entry.columns)
+    {
+        uint64_t size = 0;
+        file.read(reinterpret_cast<char*>(&size), sizeof(size));
+        if (!file) break;
+        column.resize(size);
+        file.read(reinterpret_cast<char*>(column.data()), size);
+    }
+    if (!file)
+    {
+        std::cerr << "Error reading file: " << entry.spillPath << std::endl;
+        for (std::vector<uint8_t>& column : entry.columns) std::vector<uint8_t>().swap(column);
+        return false;
+    }
+    file.close();
+
+    for (const std::vector<uint8_t>& column : entry.columns) m_compressedBytes += column.size();
+    std::error_code error;
+    std::filesystem::remove(entry.spillPath, error);
+    entry.spillPath.clear();
+    return true;
+}
+
+void SolutionStore::enforceBudget()
+{
+    while (m_compressedBytes > m_memoryBudget)
+    {
+        Entry* oldest = nullptr;
+        for (Entry& entry : m_entries)
+        {
+            if (!entry.compressed || !entry.spillPath.empty()) continue;
+            if (!oldest || entry.lastUsed < oldest->lastUsed) oldest = &entry;
+        }
+        if (!oldest || !spill(*oldest)) break;
+    }
+}
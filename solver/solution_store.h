@@ -0,0 +1,86 @@
+#ifndef _SOLUTION_STORE_H_
+#define _SOLUTION_STORE_H_
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "solution.h"
+
+// Retains every solution of a session with bounded memory.
+// Only the most recently selected solutions are kept decompressed, the rest hold their columns
+// compressed with GorillaCodec and, past the memory budget, the least recently used ones are spilled to disk.
+class SolutionStore
+{
+    public:
+        static constexpr size_t DefaultMemoryBudget = 256 * 1024 * 1024;
+        static constexpr size_t DecompressedCacheSize = 2;
+
+        // Without a spillDirectory each store spills to a directory of its own under the system temporary directory,
+        // named after the process and store, so stores of other processes or of this one never share files
+        explicit SolutionStore(size_t memoryBudget = DefaultMemoryBudget, const std::string& spillDirectory = "");
+        ~SolutionStore();
+
+        SolutionStore(const SolutionStore&) = delete;
+        SolutionStore& operator=(const SolutionStore&) = delete;
+
+        void add(Solution&& solution);
+
+        // Decompresses (and reloads from disk) on demand, the pointer is valid until the next add() or get().
+        // Null if the spilled columns could not be read back, error() then says why.
+        const Solution* get(size_t index);
+
+        size_t size() const { return m_entries.size(); }
+        const std::string& name(size_t index) const { return m_entries[index].name; }
+        const Configuration& configuration(size_t index) const { return m_entries[index].configuration; }
+        const std::string& error(size_t index) const { return m_entries[index].error; }
+
+        // Compressed bytes currently held in memory
+        size_t compressedBytes() const { return m_compressedBytes; }
+
+    private:
+        // time followed by the Solution::Field columns
+        static constexpr size_t ColumnCount = 8;
+
+        struct Entry
+        {
+            std::string name;
+            ImVec4 color;
+            Configuration configuration;
+            SpectralAnalysis spectrum;
+            CycleStatistics cycles;
+            size_t samples = 0;
+            uint64_t lastUsed = 0;
+
+            std::unique_ptr<Solution> solution;
+            std::array<std::vector<uint8_t>, ColumnCount> columns;
+            bool compressed = false;
+            std::string spillPath;
+
+            // Set once a reload from disk fails, the entry is never handed out again
+            std::string error;
+        };
+
+        static std::array<std::vector<float>*, ColumnCount> columnsOf(Solution& solution);
+
+        void touch(size_t index);
+        void compress(Entry& entry);
+        bool decompress(Entry& entry);
+        bool spill(Entry& entry);
+        bool unspill(Entry& entry);
+        void enforceBudget();
+
+    private:
+        std::vector<Entry> m_entries;
+        std::deque<size_t> m_decompressed; // Most recently used first
+        size_t m_memoryBudget;
+        std::string m_spillDirectory;
+        bool m_ownsSpillDirectory = false; // Created by the store, removed again once emptied
+        size_t m_compressedBytes = 0;
+        uint64_t m_clock = 0;
+};
+
+#endif // _SOLUTION_STORE_H_
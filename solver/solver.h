@@ -1,130 +1,190 @@
 #ifndef _SOLVER_H_
 #define _SOLVER_H_
 
+#include <algorithm>
 #include <atomic>
 #include <cmath>
 #include <vector>
 #include <iostream>
 
 #include "configuration.h"
+#include "cycle_statistics.h"
+#include "ring_buffer.h"
+#include "sectional_loads.h"
 #include "solution.h"
-#include "vec3.h"
+#include "solution_pool.h"
+#include "solver_kernel.h"
+#include "spectral.h"
 #include "util.h"
 
+// Reduced fidelity used for interactive previews, as multiples of the configuration's own steps and time
+struct PreviewFidelity
+{
+    float timeStepScale = 4;
+    float radialStepScale = 4;
+    float simTimeScale = 0.5f;
+};
+
 namespace Solver
 {
-    Solution solve(const Configuration configuration, std::atomic<float>& progress) // Configuration Copy
+    // Approximate number of samples published to the stream over a whole solve
+    constexpr size_t StreamSamples = 2000;
+
+    inline Configuration preview(Configuration configuration, const PreviewFidelity& fidelity)
+    {
+        configuration.timeStep *= std::max(fidelity.timeStepScale, 1.0f);
+        configuration.radialStep *= std::max(fidelity.radialStepScale, 1.0f);
+        configuration.simTime *= std::clamp(fidelity.simTimeScale, 0.0f, 1.0f);
+        configuration.simTime = std::max(configuration.simTime, 2 * configuration.timeStep);
+        return configuration;
+    }
+
+    // Drag of the hub as a cylinder in the crossflow, independent of the rotor state
+    inline double hubDrag(const Configuration& configuration)
     {
-        const std::vector<float> BladeAngles = Util::linspace<float>(0, 2 * Util::PI, (size_t)configuration.numBlades);
+        const float hubReynolds = (2 * configuration.freestreamVelocity[0] * configuration.hubRadius) / configuration.kinematicViscosity;
+        if (hubReynolds <= 10)
+        {
+            // Cd = 24 / Re
+            return (24 / hubReynolds) *  configuration.hubRadius * configuration.airDensity * std::pow(configuration.freestreamVelocity[0], 2) * configuration.hubHieght;
+        } 
+        else if (hubReynolds <= 1000)
+        {
+            // Cd = -0.002Re + 2.42
+            return ((-0.002 * hubReynolds) + 2.42) *  configuration.hubRadius * configuration.airDensity * std::pow(configuration.freestreamVelocity[0], 2) * configuration.hubHieght;
+        }
+        else if (hubReynolds <= 300000)
+        {
+            // Cd = 0.5
+            return 0.5 * configuration.hubRadius * configuration.airDensity * std::pow(configuration.freestreamVelocity[0], 2) * configuration.hubHieght;
+        }
+        else
+        {
+            // Cd = 0.15
+            return 0.15 * configuration.hubRadius * configuration.airDensity * std::pow(configuration.freestreamVelocity[0], 2) * configuration.hubHieght;
+        }
+    }
+
+    // Fills the loads and angular acceleration of step t from the blade forces at its rotor state
+    inline void record(const Configuration& configuration, const BladeForces& forces, double hubDrag, size_t t, Solution& solution)
+    {
+        solution.lift[t] = forces.lift;
+        solution.drag[t] = forces.drag;
+        solution.sideForce[t] = forces.sideForce;
+        solution.torque[t] = forces.torque;
+
+        // Hub Drag
+        solution.drag[t] += hubDrag;
+
+        solution.torque[t] -= solution.angularVelocity[t] * configuration.motorDamping();
+
+        solution.angularAcceleration[t] = solution.torque[t] / (configuration.propellerMomentOfInertia + configuration.motorRotorMomentOfInertia);
+    }
+
+    // RK4 Integration over one time step from a rotor state and its angular acceleration
+    inline void advance(const Configuration& configuration, float angularPosition, float angularVelocity, float angularAcceleration,
+                        float& nextAngularPosition, float& nextAngularVelocity)
+    {
+        const float dt = configuration.timeStep;
+        float k1, k2, k3, k4;
+
+        // RK4 for angular position (solution[1])
+        k1 = angularVelocity;
+        k2 = angularVelocity + (0.5f * dt * k1);
+        k3 = angularVelocity + (0.5f * dt * k2);
+        k4 = angularVelocity + (dt * k3);
+        nextAngularPosition = angularPosition + ((dt / 6) * (k1 + 2*k2 + 2*k3 + k4));
+
+        // RK4 for angular velocity (solution[2])
+        k1 = angularAcceleration;
+        k2 = angularAcceleration + (0.5f * dt * k1);
+        k3 = angularAcceleration + (0.5f * dt * k2);
+        k4 = angularAcceleration + (dt * k3);
+        nextAngularVelocity = angularVelocity + ((dt / 6) * (k1 + 2*k2 + 2*k3 + k4));
+    }
+
+    inline Solution solve(const Configuration configuration, std::atomic<float>& progress, RingBuffer<SolutionSample>* stream = nullptr,
+                          SectionalLoadWriter* capture = nullptr, WorkerTeam* team = nullptr, SolutionPool* pool = nullptr,
+                          const std::atomic<bool>* cancel = nullptr) // Configuration Copy
+    {
+        // Blade geometry, everything the blade integral needs that is fixed for the solve
+        const BladeGeometry Geometry(configuration);
+
+        // Optional intra-step parallelism, only once a step has enough sections to pay for the synchronization.
+        // A team of one still takes the chunked path, so results do not depend on the core count.
+        const bool Parallel = team && Geometry.offsetCos.size() * Geometry.radii.size() >= SolverKernel::ParallelThreshold;
+        std::vector<BladeForces> partials;
 
-        // Radius Discretization
-        const float BladeLength = configuration.propellerRadius - configuration.hubRadius;
-        const size_t RadialSteps = BladeLength / configuration.radialStep;
-        const std::vector<float> RadialDiscretization = Util::linspace<float>(configuration.hubRadius, configuration.propellerRadius, RadialSteps);
-        
         // Solution State and Time Discretization
         const size_t TimeSteps = (configuration.simTime / configuration.timeStep);
 
-        // Time, angular position, angular velocity, angular acceleration, lift, drag(fx), side force(fy), torque 
-        Solution solution(TimeSteps);
+        // Time, angular position, angular velocity, angular acceleration, lift, drag(fx), side force(fy), torque.
+        // Pooled columns are not zeroed, every step below is written before it is read.
+        Solution solution = pool ? pool->acquire(TimeSteps) : Solution(TimeSteps);
 
         // Time Discretization
-        solution.time = Util::linspace<float>(0,  configuration.simTime, TimeSteps);
+        Util::linspace<float>(0,  configuration.simTime, solution.time);
 
         // Initial Conditions
+        solution.angularPosition[0] = 0;
         solution.angularVelocity[0] = configuration.initialAngularVelocity;
 
-        // Solve
-        float phi, tangentialLocalVelocity, dynamicPressure, sectionDrag, reynolds, hubReynolds;
-        float k1, k2, k3, k4;
-        Vec3 omega, phiHat, rHat, radius, circularVeclocity, localVelocity;
+        // Live stream decimation (countdown instead of a modulo every step)
+        const size_t StreamStride = std::max<size_t>(1, TimeSteps / StreamSamples);
+        size_t streamCountdown = 0;
+
+        // Opt-in sectional load capture, streamed to <name>_sections.bin every decimation-th step
+        if (capture && !capture->begin(solution.name, Geometry.offsetCos.size(), Geometry.radii)) capture = nullptr;
+        size_t captureCountdown = 0;
+
+        // Load spectra and rotor harmonics, fed every step
+        SpectralAnalyzer analyzer(SpectralSettings(), TimeSteps, configuration.timeStep, configuration.numBlades);
+        CycleAccumulator cycles;
 
+        // Hub drag only depends on the configuration
+        const double HubDrag = hubDrag(configuration);
+
+        // Solve
         for (int t = 0; t < solution.time.size(); ++t)
         {
             progress = ((float)t / ((float)solution.time.size() - 1.0f));
-            omega = {0,0,solution.angularVelocity[t]};
 
-            for(const float& bladeAngle : BladeAngles)
+            // Cancelled solves return the steps computed so far
+            if (cancel && cancel->load(std::memory_order_relaxed))
             {
-                phi = bladeAngle + solution.angularPosition[t];
-                rHat = {std::cos(phi), std::sin(phi), 0};
-                phiHat = {-rHat[1], rHat[0], 0};                
-
-                for(const float r : RadialDiscretization)
-                {
-                    radius = r * rHat;   
-                    circularVeclocity = cross(omega, radius);
-                    localVelocity = circularVeclocity + configuration.freestreamVelocity;
-                    
-                    tangentialLocalVelocity = dot(localVelocity, phiHat);
-                    dynamicPressure = 0.5f * configuration.airDensity * std::pow(tangentialLocalVelocity, 2);
-                    reynolds = (tangentialLocalVelocity * configuration.bladeChordAt(r)) / configuration.kinematicViscosity;
-
-                    if(tangentialLocalVelocity > 0)
-                    {
-                        sectionDrag = dynamicPressure * configuration.bladeChordAt(r) * configuration.radialStep * configuration.dragCoefficientAt(r, reynolds);
-                        solution.lift[t] += dynamicPressure * configuration.bladeChordAt(r) * configuration.radialStep * configuration.liftCoefficientAt(r, reynolds);
-                        solution.torque[t] -= sectionDrag * r;
-                        solution.drag[t] -= std::sin(phi) * sectionDrag;
-                        solution.sideForce[t] -= std::cos(phi) * sectionDrag;
-                    }
-                    else // Reversed flow
-                    {
-                        sectionDrag = dynamicPressure * configuration.bladeChordAt(r) * configuration.radialStep * configuration.reverseDragCoefficientAt(r, reynolds);
-                        solution.lift[t] += dynamicPressure * configuration.bladeChordAt(r) * configuration.radialStep * configuration.reverseLiftCoefficientAt(r, reynolds);
-                        solution.torque[t] += sectionDrag * r;
-                        solution.drag[t] += std::sin(phi) * sectionDrag;
-                        solution.sideForce[t] += std::cos(phi) * sectionDrag;
-                    }
-                }
+                solution.resize(t);
+                break;
             }
-            
-            // Hub Drag
-            hubReynolds = (2 * configuration.freestreamVelocity[0] * configuration.hubRadius) / configuration.kinematicViscosity;
-            if (hubReynolds <= 10)
-            {
-                // Cd = 24 / Re
-                solution.drag[t] += (24 / hubReynolds) *  configuration.hubRadius * configuration.airDensity * std::pow(configuration.freestreamVelocity[0], 2) * configuration.hubHieght;
-            } 
-            else if (hubReynolds <= 1000)
-            {
-                // Cd = -0.002Re + 2.42
-                solution.drag[t] += ((-0.002 * hubReynolds) + 2.42) *  configuration.hubRadius * configuration.airDensity * std::pow(configuration.freestreamVelocity[0], 2) * configuration.hubHieght;
-            }
-            else if (hubReynolds <= 300000)
+
+            const BladeForces forces = Parallel ? SolverKernel::evaluateParallel(Geometry, solution.angularPosition[t], solution.angularVelocity[t], *team, partials)
+                                                : SolverKernel::evaluate(Geometry, solution.angularPosition[t], solution.angularVelocity[t]);
+            record(configuration, forces, HubDrag, t, solution);
+
+            analyzer.push(solution.time[t], solution.angularPosition[t], solution.torque[t], solution.drag[t], solution.sideForce[t]);
+            cycles.push(solution.time[t], solution.angularPosition[t], solution.angularVelocity[t], solution.drag[t], solution.sideForce[t], solution.lift[t], solution.torque[t]);
+
+            if (stream && streamCountdown-- == 0)
             {
-                // Cd = 0.5
-                solution.drag[t] += 0.5 * configuration.hubRadius * configuration.airDensity * std::pow(configuration.freestreamVelocity[0], 2) * configuration.hubHieght;
+                streamCountdown = StreamStride - 1;
+                stream->push({solution.time[t], solution.angularPosition[t], solution.angularVelocity[t], solution.angularAcceleration[t],
+                              solution.torque[t], solution.lift[t], solution.drag[t], solution.sideForce[t]});
             }
-            else
+
+            if (capture && captureCountdown-- == 0)
             {
-                // Cd = 0.15
-                solution.drag[t] += 0.15 * configuration.hubRadius * configuration.airDensity * std::pow(configuration.freestreamVelocity[0], 2) * configuration.hubHieght;
+                captureCountdown = capture->decimation() - 1;
+                SectionalLoads::evaluate(Geometry, solution.angularPosition[t], solution.angularVelocity[t], capture->append(solution.time[t]));
             }
-
-            solution.torque[t] -= solution.angularVelocity[t] / (configuration.motorVelocityConstant * configuration.motorVelocityConstant * configuration.motorResistance);
-
-            solution.angularAcceleration[t] = solution.torque[t] / (configuration.propellerMomentOfInertia + configuration.motorRotorMomentOfInertia);
             
             if(t+1 == solution.time.size()) break;
 
-            // RK4 Integration
-            #define dt configuration.timeStep
-
-            // RK4 for angular position (solution[1])
-            k1 = solution.angularVelocity[t];
-            k2 = solution.angularVelocity[t] + (0.5f * dt * k1);
-            k3 = solution.angularVelocity[t] + (0.5f * dt * k2);
-            k4 = solution.angularVelocity[t] + (dt * k3);
-            solution.angularPosition[t+1] = solution.angularPosition[t] + ((dt / 6) * (k1 + 2*k2 + 2*k3 + k4));
-
-            // RK4 for angular velocity (solution[2])
-            k1 = solution.angularAcceleration[t];
-            k2 = solution.angularAcceleration[t] + (0.5f * dt * k1);
-            k3 = solution.angularAcceleration[t] + (0.5f * dt * k2);
-            k4 = solution.angularAcceleration[t] + (dt * k3);
-            solution.angularVelocity[t+1] = solution.angularVelocity[t] + ((dt / 6) * (k1 + 2*k2 + 2*k3 + k4));
+            advance(configuration, solution.angularPosition[t], solution.angularVelocity[t], solution.angularAcceleration[t],
+                    solution.angularPosition[t+1], solution.angularVelocity[t+1]);
         }
+        if (capture) capture->finish();
+        solution.spectrum = analyzer.finish();
+        solution.cycles = cycles.finish();
+
         solution.configuration = std::move(configuration);
         solution.clean();
         return solution;
@@ -0,0 +1,428 @@
+#ifndef _SOLVER_KERNEL_H_
+#define _SOLVER_KERNEL_H_
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include <xmmintrin.h>  // SSE intrinsics
+
+#include "aero_coefficient_interpolator.h"
+#include "configuration.h"
+#include "quadrature.h"
+#include "util.h"
+#include "worker_team.h"
+
+// Blade element forces summed over every section of every blade at one instant
+struct BladeForces
+{
+    float lift = 0, drag = 0, sideForce = 0, torque = 0;
+};
+
+// Lift and drag segments every blade section last interpolated in, with the flow direction (1 forward, -1 reversed,
+// 0 before the first step) they belong to. One plane per field, blade and station major within a plane, so the
+// kernel loads the segments of several sections at once.
+struct SegmentCache
+{
+    enum Plane { Direction, LiftLower, LiftUpper, LiftX1, LiftX2, LiftY1, LiftY2, DragLower, DragUpper, DragX1, DragX2, DragY1, DragY2, Planes };
+
+    size_t sections = 0;
+    std::vector<float> values;
+
+    void resize(size_t count)
+    {
+        sections = count;
+        values.assign(Planes * count, 0.0f);
+    }
+
+    const float* plane(Plane plane) const { return values.data() + plane * sections; }
+
+    void store(size_t section, float direction, const AeroCoefficientInterpolator::Segment& lift, const AeroCoefficientInterpolator::Segment& drag)
+    {
+        const float fields[Planes] = {direction, lift.lower, lift.upper, lift.x1, lift.x2, lift.y1, lift.y2,
+                                      drag.lower, drag.upper, drag.x1, drag.x2, drag.y1, drag.y2};
+        for (size_t plane = 0; plane < Planes; ++plane) values[plane * sections + section] = fields[plane];
+    }
+};
+
+// Everything the blade integral needs that stays fixed for a whole solve
+struct BladeGeometry
+{
+    explicit BladeGeometry(const Configuration& configuration);
+
+    std::vector<float> radii, weights, chords, pitches;
+    std::vector<float> offsetCos, offsetSin; // Blade angular offsets
+
+    // With Reynolds independent polars every section's coefficients only depend on its pitch, so they are
+    // tabulated once and the inner loop needs no lookups at all
+    bool tabulated = false;
+    std::vector<float> liftCoefficients, dragCoefficients, reverseLiftCoefficients, reverseDragCoefficients;
+
+    // Otherwise the pitch still fixes every section's angle of attack, so each section keeps its coefficient at every
+    // Reynolds number of each polar (station major) and a step interpolates in the section's last segment, only
+    // bracketing the Reynolds number again once it leaves it. The cache makes a geometry single threaded apart from
+    // the disjoint sections of evaluateParallel, concurrent solves each build their own.
+    std::vector<float> liftColumns, dragColumns, reverseLiftColumns, reverseDragColumns;
+    mutable SegmentCache segments;
+
+    float freestreamX, freestreamY, airDensity, kinematicViscosity;
+    const AeroCoefficientInterpolator *liftPolar, *dragPolar, *reverseLiftPolar, *reverseDragPolar;
+};
+
+namespace SolverKernel
+{
+    // Tabulated sections are summed in 4 SSE lanes (stations i, i+1, i+2, i+3), leftover stations go into the first lanes
+    // and the lanes are reduced in a fixed order.
+    constexpr size_t Lanes = 4;
+
+    // Tabulated coefficients, branch free. Stations [first, first + stations).
+    inline void integrateTabulated(const BladeGeometry& geometry, size_t first, size_t stations, float cosPhi, float sinPhi, float angularVelocity, BladeForces& forces)
+    {
+        const float* radii = geometry.radii.data() + first;
+        const float* weights = geometry.weights.data() + first;
+        const float* chords = geometry.chords.data() + first;
+        const float* liftCoefficients = geometry.liftCoefficients.data() + first;
+        const float* dragCoefficients = geometry.dragCoefficients.data() + first;
+        const float* reverseLiftCoefficients = geometry.reverseLiftCoefficients.data() + first;
+        const float* reverseDragCoefficients = geometry.reverseDragCoefficients.data() + first;
+        const float halfDensity = 0.5f * geometry.airDensity;
+
+        // Freestream component along phi-hat, the rotation adds omega * r
+        const float freestreamTangential = geometry.freestreamY * cosPhi - geometry.freestreamX * sinPhi;
+
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 signBit = _mm_set1_ps(-0.0f);
+        const __m128 omega = _mm_set1_ps(angularVelocity);
+        const __m128 freestream = _mm_set1_ps(freestreamTangential);
+        const __m128 halfRho = _mm_set1_ps(halfDensity);
+        __m128 liftSum = zero, torqueSum = zero, dragSum = zero;
+
+        const size_t body = stations - stations % Lanes;
+        for (size_t i = 0; i < body; i += Lanes)
+        {
+            const __m128 r = _mm_loadu_ps(radii + i);
+            const __m128 tangentialLocalVelocity = _mm_add_ps(_mm_mul_ps(omega, r), freestream);
+            const __m128 sectionArea = _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(_mm_mul_ps(halfRho, tangentialLocalVelocity), tangentialLocalVelocity),
+                                                             _mm_loadu_ps(chords + i)), _mm_loadu_ps(weights + i));
+
+            // Forward flow drags against the rotation (negated drag), reversed flow drives it
+            const __m128 forward = _mm_cmpgt_ps(tangentialLocalVelocity, zero);
+            const __m128 dragCoefficient = _mm_or_ps(_mm_and_ps(forward, _mm_xor_ps(_mm_loadu_ps(dragCoefficients + i), signBit)),
+                                                     _mm_andnot_ps(forward, _mm_loadu_ps(reverseDragCoefficients + i)));
+            const __m128 liftCoefficient = _mm_or_ps(_mm_and_ps(forward, _mm_loadu_ps(liftCoefficients + i)),
+                                                     _mm_andnot_ps(forward, _mm_loadu_ps(reverseLiftCoefficients + i)));
+
+            const __m128 sectionDrag = _mm_mul_ps(sectionArea, dragCoefficient);
+            liftSum = _mm_add_ps(liftSum, _mm_mul_ps(sectionArea, liftCoefficient));
+            torqueSum = _mm_add_ps(torqueSum, _mm_mul_ps(sectionDrag, r));
+            dragSum = _mm_add_ps(dragSum, sectionDrag);
+        }
+
+        float lift[Lanes], torque[Lanes], drag[Lanes];
+        _mm_storeu_ps(lift, liftSum);
+        _mm_storeu_ps(torque, torqueSum);
+        _mm_storeu_ps(drag, dragSum);
+
+        // Same arithmetic as a single lane of the loop above
+        for (size_t i = body; i < stations; ++i)
+        {
+            const float r = radii[i];
+            const float tangentialLocalVelocity = angularVelocity * r + freestreamTangential;
+            const float sectionArea = halfDensity * tangentialLocalVelocity * tangentialLocalVelocity * chords[i] * weights[i];
+            const bool forward = tangentialLocalVelocity > 0;
+            const float sectionDrag = sectionArea * (forward ? -dragCoefficients[i] : reverseDragCoefficients[i]);
+            lift[i - body] += sectionArea * (forward ? liftCoefficients[i] : reverseLiftCoefficients[i]);
+            torque[i - body] += sectionDrag * r;
+            drag[i - body] += sectionDrag;
+        }
+
+        // Drag and side force share the signed section drag, projected once per blade
+        float bladeDrag = 0;
+        for (size_t lane = 0; lane < Lanes; ++lane)
+        {
+            forces.lift += lift[lane];
+            forces.torque += torque[lane];
+            bladeDrag += drag[lane];
+        }
+        forces.drag += sinPhi * bladeDrag;
+        forces.sideForce += cosPhi * bladeDrag;
+    }
+
+    // Linear interpolation of four sections in their cached segments, the same arithmetic as the polar's own
+    inline __m128 interpolateSegments(const SegmentCache& cache, SegmentCache::Plane x1Plane, size_t section, __m128 x)
+    {
+        const __m128 x1 = _mm_loadu_ps(cache.plane(x1Plane) + section);
+        const __m128 x2 = _mm_loadu_ps(cache.plane(SegmentCache::Plane(x1Plane + 1)) + section);
+        const __m128 y1 = _mm_loadu_ps(cache.plane(SegmentCache::Plane(x1Plane + 2)) + section);
+        const __m128 y2 = _mm_loadu_ps(cache.plane(SegmentCache::Plane(x1Plane + 3)) + section);
+        return _mm_add_ps(y1, _mm_div_ps(_mm_mul_ps(_mm_sub_ps(y2, y1), _mm_sub_ps(x, x1)), _mm_sub_ps(x2, x1)));
+    }
+
+    // Single section version of interpolateSegments
+    inline float interpolateSegment(const SegmentCache& cache, SegmentCache::Plane x1Plane, size_t section, float x)
+    {
+        const float x1 = cache.plane(x1Plane)[section], x2 = cache.plane(SegmentCache::Plane(x1Plane + 1))[section];
+        const float y1 = cache.plane(SegmentCache::Plane(x1Plane + 2))[section], y2 = cache.plane(SegmentCache::Plane(x1Plane + 3))[section];
+        return y1 + (y2 - y1) * (x - x1) / (x2 - x1);
+    }
+
+    // Per section polar lookups, needed once coefficients depend on Reynolds number. Same lanes as integrateTabulated,
+    // interpolated in each section's cached segments. A section's Reynolds number moves little between steps, so
+    // only the few that leave their segment or reverse their flow look it up again.
+    inline void integrateLookup(const BladeGeometry& geometry, size_t blade, size_t first, size_t stations, float cosPhi, float sinPhi, float angularVelocity, BladeForces& forces)
+    {
+        const float* radii = geometry.radii.data() + first;
+        const float* weights = geometry.weights.data() + first;
+        const float* chords = geometry.chords.data() + first;
+        const size_t section = blade * geometry.radii.size() + first;
+        SegmentCache& cache = geometry.segments;
+        const float halfDensity = 0.5f * geometry.airDensity;
+
+        const size_t liftTables = geometry.liftPolar->reynoldsNumbers().size();
+        const size_t dragTables = geometry.dragPolar->reynoldsNumbers().size();
+        const size_t reverseLiftTables = geometry.reverseLiftPolar->reynoldsNumbers().size();
+        const size_t reverseDragTables = geometry.reverseDragPolar->reynoldsNumbers().size();
+        const float* liftColumns = geometry.liftColumns.data() + first * liftTables;
+        const float* dragColumns = geometry.dragColumns.data() + first * dragTables;
+        const float* reverseLiftColumns = geometry.reverseLiftColumns.data() + first * reverseLiftTables;
+        const float* reverseDragColumns = geometry.reverseDragColumns.data() + first * reverseDragTables;
+
+        // Looks up station i in the polars of its flow direction, at the magnitude of its Reynolds number
+        auto refresh = [&](size_t i, bool forward, float reynolds) {
+            if (forward)
+            {
+                cache.store(section + i, 1.0f, geometry.liftPolar->segmentAt(liftColumns + i * liftTables, reynolds),
+                            geometry.dragPolar->segmentAt(dragColumns + i * dragTables, reynolds));
+            }
+            else // Reversed flow
+            {
+                cache.store(section + i, -1.0f, geometry.reverseLiftPolar->segmentAt(reverseLiftColumns + i * reverseLiftTables, reynolds),
+                            geometry.reverseDragPolar->segmentAt(reverseDragColumns + i * reverseDragTables, reynolds));
+            }
+        };
+
+        const float freestreamTangential = geometry.freestreamY * cosPhi - geometry.freestreamX * sinPhi;
+
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 signBit = _mm_set1_ps(-0.0f);
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 omega = _mm_set1_ps(angularVelocity);
+        const __m128 freestream = _mm_set1_ps(freestreamTangential);
+        const __m128 halfRho = _mm_set1_ps(halfDensity);
+        const __m128 viscosity = _mm_set1_ps(geometry.kinematicViscosity);
+        __m128 liftSum = zero, torqueSum = zero, dragSum = zero;
+
+        const size_t body = stations - stations % Lanes;
+        for (size_t i = 0; i < body; i += Lanes)
+        {
+            const __m128 r = _mm_loadu_ps(radii + i);
+            const __m128 chord = _mm_loadu_ps(chords + i);
+            const __m128 tangentialLocalVelocity = _mm_add_ps(_mm_mul_ps(omega, r), freestream);
+            // Reversed flow has a negative Reynolds number, the polars are tabulated over its magnitude
+            const __m128 reynolds = _mm_andnot_ps(signBit, _mm_div_ps(_mm_mul_ps(tangentialLocalVelocity, chord), viscosity));
+            const __m128 sectionArea = _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(_mm_mul_ps(halfRho, tangentialLocalVelocity), tangentialLocalVelocity),
+                                                             chord), _mm_loadu_ps(weights + i));
+
+            // A lane's segments hold while its flow keeps its direction and its Reynolds number stays inside both
+            const __m128 forward = _mm_cmpgt_ps(tangentialLocalVelocity, zero);
+            const __m128 direction = _mm_or_ps(_mm_and_ps(forward, one), _mm_andnot_ps(forward, _mm_xor_ps(one, signBit)));
+            const size_t k = section + i;
+            __m128 valid = _mm_cmpeq_ps(direction, _mm_loadu_ps(cache.plane(SegmentCache::Direction) + k));
+            valid = _mm_and_ps(valid, _mm_cmple_ps(_mm_loadu_ps(cache.plane(SegmentCache::LiftLower) + k), reynolds));
+            valid = _mm_and_ps(valid, _mm_cmplt_ps(reynolds, _mm_loadu_ps(cache.plane(SegmentCache::LiftUpper) + k)));
+            valid = _mm_and_ps(valid, _mm_cmple_ps(_mm_loadu_ps(cache.plane(SegmentCache::DragLower) + k), reynolds));
+            valid = _mm_and_ps(valid, _mm_cmplt_ps(reynolds, _mm_loadu_ps(cache.plane(SegmentCache::DragUpper) + k)));
+
+            const int stale = ~_mm_movemask_ps(valid) & ((1 << Lanes) - 1);
+            if (stale)
+            {
+                float reynoldsLanes[Lanes];
+                _mm_storeu_ps(reynoldsLanes, reynolds);
+                const int forwardLanes = _mm_movemask_ps(forward);
+                for (size_t lane = 0; lane < Lanes; ++lane)
+                {
+                    if (stale & (1 << lane)) refresh(i + lane, forwardLanes & (1 << lane), reynoldsLanes[lane]);
+                }
+            }
+
+            // Forward flow drags against the rotation (negated drag), reversed flow drives it
+            const __m128 liftCoefficient = interpolateSegments(cache, SegmentCache::LiftX1, k, reynolds);
+            const __m128 dragCoefficient = _mm_xor_ps(interpolateSegments(cache, SegmentCache::DragX1, k, reynolds), _mm_and_ps(forward, signBit));
+
+            const __m128 sectionDrag = _mm_mul_ps(sectionArea, dragCoefficient);
+            liftSum = _mm_add_ps(liftSum, _mm_mul_ps(sectionArea, liftCoefficient));
+            torqueSum = _mm_add_ps(torqueSum, _mm_mul_ps(sectionDrag, r));
+            dragSum = _mm_add_ps(dragSum, sectionDrag);
+        }
+
+        float lift[Lanes], torque[Lanes], drag[Lanes];
+        _mm_storeu_ps(lift, liftSum);
+        _mm_storeu_ps(torque, torqueSum);
+        _mm_storeu_ps(drag, dragSum);
+
+        // Same arithmetic as a single lane of the loop above
+        for (size_t i = body; i < stations; ++i)
+        {
+            const float r = radii[i];
+            const float tangentialLocalVelocity = angularVelocity * r + freestreamTangential;
+            const float reynolds = std::abs((tangentialLocalVelocity * chords[i]) / geometry.kinematicViscosity);
+            const float sectionArea = halfDensity * tangentialLocalVelocity * tangentialLocalVelocity * chords[i] * weights[i];
+            const bool forward = tangentialLocalVelocity > 0;
+
+            const size_t k = section + i;
+            const auto inside = [&](SegmentCache::Plane lower) {
+                return cache.plane(lower)[k] <= reynolds && reynolds < cache.plane(SegmentCache::Plane(lower + 1))[k];
+            };
+            if (cache.plane(SegmentCache::Direction)[k] != (forward ? 1.0f : -1.0f) || !inside(SegmentCache::LiftLower) || !inside(SegmentCache::DragLower))
+            {
+                refresh(i, forward, reynolds);
+            }
+
+            const float dragCoefficient = interpolateSegment(cache, SegmentCache::DragX1, k, reynolds);
+            const float sectionDrag = sectionArea * (forward ? -dragCoefficient : dragCoefficient);
+            lift[i - body] += sectionArea * interpolateSegment(cache, SegmentCache::LiftX1, k, reynolds);
+            torque[i - body] += sectionDrag * r;
+            drag[i - body] += sectionDrag;
+        }
+
+        // Drag and side force share the signed section drag, projected once per blade
+        float bladeDrag = 0;
+        for (size_t lane = 0; lane < Lanes; ++lane)
+        {
+            forces.lift += lift[lane];
+            forces.torque += torque[lane];
+            bladeDrag += drag[lane];
+        }
+        forces.drag += sinPhi * bladeDrag;
+        forces.sideForce += cosPhi * bladeDrag;
+    }
+
+    // Blade element forces at one rotor state, every blade integrated in one pass
+    inline BladeForces evaluate(const BladeGeometry& geometry, float angularPosition, float angularVelocity)
+    {
+        BladeForces forces;
+        const float cosTheta = std::cos(angularPosition);
+        const float sinTheta = std::sin(angularPosition);
+
+        const size_t stations = geometry.radii.size();
+        for (size_t b = 0; b < geometry.offsetCos.size(); ++b)
+        {
+            // phi = blade offset + angular position
+            const float cosPhi = geometry.offsetCos[b] * cosTheta - geometry.offsetSin[b] * sinTheta;
+            const float sinPhi = geometry.offsetSin[b] * cosTheta + geometry.offsetCos[b] * sinTheta;
+
+            if (geometry.tabulated) integrateTabulated(geometry, 0, stations, cosPhi, sinPhi, angularVelocity, forces);
+            else integrateLookup(geometry, b, 0, stations, cosPhi, sinPhi, angularVelocity, forces);
+        }
+        return forces;
+    }
+
+    // Stations per unit of work of the parallel kernel, a multiple of Lanes
+    constexpr size_t ParallelChunkStations = 2048;
+
+    // Blade sections per step from which evaluateParallel pays for its synchronization
+    constexpr size_t ParallelThreshold = 16384;
+
+    // Splits every blade into chunks of ParallelChunkStations and integrates the chunks across the team. Chunks only
+    // depend on the station count and are summed in chunk order, so the result is bitwise the same for any
+    // team size, though not the same as evaluate() which sums each blade in one pass.
+    // partials is scratch space, kept by the caller to avoid an allocation every step.
+    inline BladeForces evaluateParallel(const BladeGeometry& geometry, float angularPosition, float angularVelocity, WorkerTeam& team,
+                                        std::vector<BladeForces>& partials)
+    {
+        const size_t stations = geometry.radii.size();
+        const size_t chunks = (stations + ParallelChunkStations - 1) / ParallelChunkStations;
+        partials.assign(geometry.offsetCos.size() * chunks, BladeForces());
+
+        const float cosTheta = std::cos(angularPosition);
+        const float sinTheta = std::sin(angularPosition);
+
+        auto body = [&](size_t unit) {
+            const size_t b = unit / chunks;
+            const size_t first = (unit % chunks) * ParallelChunkStations;
+            const size_t count = std::min(ParallelChunkStations, stations - first);
+            const float cosPhi = geometry.offsetCos[b] * cosTheta - geometry.offsetSin[b] * sinTheta;
+            const float sinPhi = geometry.offsetSin[b] * cosTheta + geometry.offsetCos[b] * sinTheta;
+
+            if (geometry.tabulated) integrateTabulated(geometry, first, count, cosPhi, sinPhi, angularVelocity, partials[unit]);
+            else integrateLookup(geometry, b, first, count, cosPhi, sinPhi, angularVelocity, partials[unit]);
+        };
+        team.run(partials.size(), body);
+
+        BladeForces forces;
+        for (const BladeForces& partial : partials)
+        {
+            forces.lift += partial.lift;
+            forces.drag += partial.drag;
+            forces.sideForce += partial.sideForce;
+            forces.torque += partial.torque;
+        }
+        return forces;
+    }
+}
+
+inline BladeGeometry::BladeGeometry(const Configuration& configuration)
+    : freestreamX(configuration.freestreamVelocity[0]),
+      freestreamY(configuration.freestreamVelocity[1]),
+      airDensity(configuration.airDensity),
+      kinematicViscosity(configuration.kinematicViscosity),
+      liftPolar(&configuration.liftPolar()),
+      dragPolar(&configuration.dragPolar()),
+      reverseLiftPolar(&configuration.reverseLiftPolar()),
+      reverseDragPolar(&configuration.reverseDragPolar())
+{
+    RadialStations stations = Quadrature::radialStations(configuration);
+    radii = std::move(stations.radii);
+    weights = std::move(stations.weights);
+    chords.reserve(radii.size());
+    pitches.reserve(radii.size());
+    for (const float r : radii)
+    {
+        chords.push_back(configuration.bladeChordAt(r));
+        pitches.push_back(configuration.bladePitchAt(r));
+    }
+
+    tabulated = liftPolar->reynoldsIndependent() && dragPolar->reynoldsIndependent() &&
+                reverseLiftPolar->reynoldsIndependent() && reverseDragPolar->reynoldsIndependent();
+    if (tabulated)
+    {
+        for (std::vector<float>* table : {&liftCoefficients, &dragCoefficients, &reverseLiftCoefficients, &reverseDragCoefficients})
+        {
+            table->reserve(pitches.size());
+        }
+        for (const float pitch : pitches)
+        {
+            liftCoefficients.push_back(liftPolar->coefficientAt(pitch, 0));
+            dragCoefficients.push_back(dragPolar->coefficientAt(pitch, 0));
+            reverseLiftCoefficients.push_back(reverseLiftPolar->coefficientAt(pitch, 0));
+            reverseDragCoefficients.push_back(reverseDragPolar->coefficientAt(pitch, 0));
+        }
+    }
+    else
+    {
+        const std::array<std::pair<const AeroCoefficientInterpolator*, std::vector<float>*>, 4> polars = {{
+            {liftPolar, &liftColumns}, {dragPolar, &dragColumns}, {reverseLiftPolar, &reverseLiftColumns}, {reverseDragPolar, &reverseDragColumns}
+        }};
+        for (const auto& [polar, columns] : polars)
+        {
+            columns->reserve(pitches.size() * polar->reynoldsNumbers().size());
+            for (const float pitch : pitches)
+            {
+                const std::vector<float> column = polar->coefficientsAt(pitch);
+                columns->insert(columns->end(), column.begin(), column.end());
+            }
+        }
+        segments.resize(static_cast<size_t>(std::max(configuration.numBlades, 0)) * radii.size());
+    }
+
+    offsetCos.reserve(configuration.numBlades);
+    offsetSin.reserve(configuration.numBlades);
+    for (int b = 0; b < configuration.numBlades; ++b)
+    {
+        offsetCos.push_back(static_cast<float>(std::cos(2.0 * Util::PI * b / configuration.numBlades)));
+        offsetSin.push_back(static_cast<float>(std::sin(2.0 * Util::PI * b / configuration.numBlades)));
+    }
+}
+
+#endif // _SOLVER_KERNEL_H_
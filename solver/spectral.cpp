@@ -0,0 +1,202 @@
+#include "spectral.h"
+#include "util.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Shorter tails than this are not worth a spectrum
+    constexpr size_t MinSegmentLength = 16;
+
+    // In-place iterative radix-2 FFT on split real and imaginary parts, size must be a power of two and the
+    // twiddles hold e^(-2 pi i k / size) for the first half. Split arrays rather than std::complex, whose
+    // signed zero handling keeps the butterflies from vectorizing and runs about ten times slower.
+    void fft(std::vector<float>& real, std::vector<float>& imag, const std::vector<float>& twiddleReal, const std::vector<float>& twiddleImag)
+    {
+        const size_t n = real.size();
+        for (size_t i = 1, j = 0; i < n; ++i)
+        {
+            size_t bit = n >> 1;
+            for (; j & bit; bit >>= 1) j ^= bit;
+            j ^= bit;
+            if (i < j)
+            {
+                std::swap(real[i], real[j]);
+                std::swap(imag[i], imag[j]);
+            }
+        }
+
+        for (size_t length = 2; length <= n; length <<= 1)
+        {
+            const size_t half = length / 2, stride = n / length;
+            for (size_t start = 0; start < n; start += length)
+            {
+                for (size_t k = 0; k < half; ++k)
+                {
+                    const float cosine = twiddleReal[k * stride], sine = twiddleImag[k * stride];
+                    const size_t even = start + k, odd = even + half;
+                    const float oddReal = real[odd] * cosine - imag[odd] * sine;
+                    const float oddImag = real[odd] * sine + imag[odd] * cosine;
+                    real[odd] = real[even] - oddReal;
+                    imag[odd] = imag[even] - oddImag;
+                    real[even] += oddReal;
+                    imag[even] += oddImag;
+                }
+            }
+        }
+    }
+}
+
+SpectralAnalyzer::SpectralAnalyzer(const SpectralSettings& settings, size_t timeSteps, float timeStep, int blades) : m_blades(std::max(blades, 1))
+{
+    m_analysis.settings = settings;
+    m_analysis.sampleRate = 1.0f / timeStep;
+
+    // Largest power of two fitting both the requested length and the analysed tail, none if the tail is too short
+    const size_t tail = std::min(timeSteps, static_cast<size_t>(timeSteps * std::clamp(settings.window, 0.0f, 1.0f)));
+    const size_t limit = std::min(tail, static_cast<size_t>(std::max(settings.segmentLength, 0)));
+    m_segmentLength = 0;
+    if (limit >= MinSegmentLength)
+    {
+        m_segmentLength = MinSegmentLength;
+        while (2 * m_segmentLength <= limit) m_segmentLength *= 2;
+    }
+    m_hop = std::max<size_t>(1, static_cast<size_t>(m_segmentLength * (1.0f - std::clamp(settings.overlap, 0.0f, 0.9f))));
+    m_welchStart = timeSteps - tail;
+    m_analysis.settings.segmentLength = static_cast<int>(m_segmentLength);
+    if (m_segmentLength == 0) return;
+
+    // Periodic Hann taper
+    m_taper.resize(m_segmentLength);
+    for (size_t i = 0; i < m_segmentLength; ++i)
+    {
+        m_taper[i] = 0.5f - 0.5f * std::cos(2.0f * Util::PI * i / m_segmentLength);
+        m_taperPower += m_taper[i] * m_taper[i];
+    }
+
+    m_real.resize(m_segmentLength);
+    m_imag.resize(m_segmentLength);
+    m_twiddleReal.resize(m_segmentLength / 2);
+    m_twiddleImag.resize(m_segmentLength / 2);
+    for (size_t k = 0; k < m_segmentLength / 2; ++k)
+    {
+        m_twiddleReal[k] = std::cos(2.0f * Util::PI * k / m_segmentLength);
+        m_twiddleImag[k] = -std::sin(2.0f * Util::PI * k / m_segmentLength);
+    }
+
+    const size_t bins = m_segmentLength / 2 + 1;
+    m_analysis.frequency.resize(bins);
+    for (size_t k = 0; k < bins; ++k) m_analysis.frequency[k] = k * m_analysis.sampleRate / m_segmentLength;
+    for (size_t s = 0; s < SpectralSignalCount; ++s)
+    {
+        m_segment[s].assign(m_segmentLength, 0.0f);
+        m_power[s].assign(bins, 0.0);
+    }
+}
+
+void SpectralAnalyzer::push(float time, float angularPosition, float torque, float drag, float sideForce)
+{
+    const float values[SpectralSignalCount] = {torque, drag, sideForce};
+
+    if (m_segmentLength && m_step >= m_welchStart)
+    {
+        const size_t sample = m_step - m_welchStart;
+        for (size_t s = 0; s < SpectralSignalCount; ++s) m_segment[s][sample % m_segmentLength] = values[s];
+        if (sample + 1 >= m_segmentLength && (sample + 1 - m_segmentLength) % m_hop == 0) processSegment();
+    }
+
+    // Each revolution integrates x(theta) e^(-ik theta) dtheta. The revolution mean is projected out at the
+    // end, so the few degrees a discrete revolution over- or undershoots do not leak the mean into the harmonics.
+    const long long revolution = static_cast<long long>(std::floor(angularPosition / (2.0f * Util::PI)));
+    if (m_step > 0)
+    {
+        if (revolution != m_revolution && m_sweptAngle > Util::PI)
+        {
+            m_analysis.revolutionTime.push_back(time);
+            for (size_t s = 0; s < SpectralSignalCount; ++s)
+            {
+                const double mean = m_mean[s] / m_sweptAngle;
+                m_analysis.rotorHarmonic[s].push_back(static_cast<float>(2.0 * std::abs(m_rotor[s] - mean * m_rotorBasis) / m_sweptAngle));
+                m_analysis.bladePassingHarmonic[s].push_back(static_cast<float>(2.0 * std::abs(m_bladePassing[s] - mean * m_bladePassingBasis) / m_sweptAngle));
+            }
+        }
+        if (revolution != m_revolution)
+        {
+            m_rotor = {};
+            m_bladePassing = {};
+            m_mean = {};
+            m_rotorBasis = m_bladePassingBasis = 0;
+            m_sweptAngle = 0;
+        }
+
+        // The blade passing phasor is a power of the rotor one, which saves a sine and cosine every step
+        const double swept = std::abs(static_cast<double>(angularPosition) - m_previousAngle);
+        const double unitCos = std::cos(angularPosition), unitSin = -std::sin(angularPosition);
+        double powerCos = unitCos, powerSin = unitSin;
+        for (int b = 1; b < m_blades; ++b)
+        {
+            const double nextCos = powerCos * unitCos - powerSin * unitSin;
+            powerSin = powerCos * unitSin + powerSin * unitCos;
+            powerCos = nextCos;
+        }
+        const std::complex<double> rotor(unitCos * swept, unitSin * swept);
+        const std::complex<double> bladePassing(powerCos * swept, powerSin * swept);
+        for (size_t s = 0; s < SpectralSignalCount; ++s)
+        {
+            m_rotor[s] += static_cast<double>(values[s]) * rotor;
+            m_bladePassing[s] += static_cast<double>(values[s]) * bladePassing;
+            m_mean[s] += values[s] * swept;
+        }
+        m_rotorBasis += rotor;
+        m_bladePassingBasis += bladePassing;
+        m_sweptAngle += swept;
+    }
+    m_revolution = revolution;
+    m_previousAngle = angularPosition;
+    ++m_step;
+}
+
+void SpectralAnalyzer::processSegment()
+{
+    // The newest sample was just written, so the oldest one follows it in the ring
+    const size_t oldest = (m_step - m_welchStart + 1) % m_segmentLength;
+    for (size_t s = 0; s < SpectralSignalCount; ++s)
+    {
+        const std::vector<float>& segment = m_segment[s];
+        double mean = 0;
+        for (const float value : segment) mean += value;
+        mean /= m_segmentLength;
+
+        const size_t wrapped = m_segmentLength - oldest;
+        for (size_t i = 0; i < wrapped; ++i) m_real[i] = (segment[oldest + i] - static_cast<float>(mean)) * m_taper[i];
+        for (size_t i = wrapped; i < m_segmentLength; ++i) m_real[i] = (segment[i - wrapped] - static_cast<float>(mean)) * m_taper[i];
+        std::fill(m_imag.begin(), m_imag.end(), 0.0f);
+
+        fft(m_real, m_imag, m_twiddleReal, m_twiddleImag);
+        for (size_t k = 0; k < m_power[s].size(); ++k) m_power[s][k] += m_real[k] * m_real[k] + m_imag[k] * m_imag[k];
+    }
+    ++m_analysis.segments;
+}
+
+SpectralAnalysis SpectralAnalyzer::finish()
+{
+    if (m_analysis.segments == 0)
+    {
+        m_analysis.frequency.clear();
+        return std::move(m_analysis);
+    }
+
+    // One-sided density: every bin but DC and Nyquist also carries its negative frequency
+    const double scale = 1.0 / (m_analysis.sampleRate * m_taperPower * m_analysis.segments);
+    const size_t nyquist = m_segmentLength / 2;
+    for (size_t s = 0; s < SpectralSignalCount; ++s)
+    {
+        m_analysis.psd[s].resize(m_power[s].size());
+        for (size_t k = 0; k < m_power[s].size(); ++k)
+        {
+            m_analysis.psd[s][k] = static_cast<float>(m_power[s][k] * scale * (k == 0 || k == nyquist ? 1.0 : 2.0));
+        }
+    }
+    return std::move(m_analysis);
+}
@@ -0,0 +1,80 @@
+#ifndef _SPECTRAL_H_
+#define _SPECTRAL_H_
+
+#include <array>
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+// Load signals the solver analyses while it runs, in this order
+enum class SpectralSignal : size_t { Torque = 0, Drag, SideForce, Count };
+constexpr size_t SpectralSignalCount = static_cast<size_t>(SpectralSignal::Count);
+inline constexpr std::array<const char*, SpectralSignalCount> SpectralSignalNames = {"Torque (Nm)", "Drag (N)", "Side Force (N)"};
+
+struct SpectralSettings
+{
+    // Welch segment length in time steps, rounded down to a power of two
+    int segmentLength = 1024;
+
+    // Fraction of a segment shared with the next one
+    float overlap = 0.5f;
+
+    // Welch averages over the last window fraction of the simulated time, after the spin-up transient
+    float window = 0.5f;
+};
+
+struct SpectralAnalysis
+{
+    SpectralSettings settings;
+    float sampleRate = 0;
+    size_t segments = 0;
+
+    // One-sided Welch power spectral density of each signal, units^2/Hz, mean removed per segment
+    std::vector<float> frequency;
+    std::array<std::vector<float>, SpectralSignalCount> psd;
+
+    // Amplitude of the once per revolution and blade passing harmonics over every completed revolution
+    std::vector<float> revolutionTime;
+    std::array<std::vector<float>, SpectralSignalCount> rotorHarmonic, bladePassingHarmonic;
+};
+
+// Streaming spectral estimators fed one full rate time step at a time.
+// Only one Welch segment per signal is buffered, so nothing proportional to the run length is kept besides
+// the per revolution harmonic amplitudes. The harmonics are demodulated against the rotor angle rather than
+// at a fixed frequency, which keeps them locked to 1x and Nx the rotor speed while it spins up.
+class SpectralAnalyzer
+{
+    public:
+        SpectralAnalyzer(const SpectralSettings& settings, size_t timeSteps, float timeStep, int blades);
+
+        void push(float time, float angularPosition, float torque, float drag, float sideForce);
+
+        // Averages the Welch segments and hands over the result
+        SpectralAnalysis finish();
+
+    private:
+        void processSegment();
+
+        SpectralAnalysis m_analysis;
+        int m_blades;
+
+        // Welch segment ring, [signal][sample]
+        size_t m_segmentLength, m_hop, m_welchStart;
+        std::array<std::vector<float>, SpectralSignalCount> m_segment;
+        std::vector<float> m_taper;
+        std::vector<float> m_real, m_imag, m_twiddleReal, m_twiddleImag;
+        std::array<std::vector<double>, SpectralSignalCount> m_power;
+        float m_taperPower = 0;
+        size_t m_step = 0;
+
+        // Harmonic accumulators of the current revolution, (cos, sin) weighted by the swept angle, and the
+        // same integrals of the signal mean and of a constant for projecting the mean out
+        std::array<std::complex<double>, SpectralSignalCount> m_rotor = {}, m_bladePassing = {};
+        std::array<double, SpectralSignalCount> m_mean = {};
+        std::complex<double> m_rotorBasis = 0, m_bladePassingBasis = 0;
+        double m_sweptAngle = 0;
+        float m_previousAngle = 0;
+        long long m_revolution = 0;
+};
+
+#endif // _SPECTRAL_H_
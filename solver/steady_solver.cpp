@@ -0,0 +1,165 @@
+#include "steady_solver.h"
+#include "solver.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    constexpr int MaxIterations = 100;
+
+    // Net torque, counting kernel calls. Sections switching into reverse flow make the loads kinked, so the
+    // cycle average converges only algebraically in its samples.
+    struct CycleAverage
+    {
+        const BladeGeometry& geometry;
+        const int samples;
+        const double motorDamping;
+        size_t evaluations = 0;
+
+        BladeForces forces(double angularVelocity)
+        {
+            evaluations += samples;
+            return SteadySolver::cycleAveragedForces(geometry, angularVelocity, samples);
+        }
+
+        double netTorque(double angularVelocity)
+        {
+            return forces(angularVelocity).torque - angularVelocity * motorDamping;
+        }
+    };
+
+    // Brent's method on a bracket [a, b] with f(a) and f(b) of opposite sign
+    template<typename Function>
+    double brent(Function f, double a, double b, double fa, double fb, double tolerance)
+    {
+        double c = b, fc = fb, d = b - a, e = d;
+        for (int iteration = 0; iteration < MaxIterations; ++iteration)
+        {
+            if ((fb > 0) == (fc > 0))
+            {
+                c = a;
+                fc = fa;
+                d = e = b - a;
+            }
+            if (std::abs(fc) < std::abs(fb))
+            {
+                a = b; b = c; c = a;
+                fa = fb; fb = fc; fc = fa;
+            }
+
+            const double step = 2.0 * std::numeric_limits<double>::epsilon() * std::abs(b) + 0.5 * tolerance;
+            const double middle = 0.5 * (c - b);
+            if (std::abs(middle) <= step || fb == 0) return b;
+
+            if (std::abs(e) >= step && std::abs(fa) > std::abs(fb))
+            {
+                // Inverse quadratic interpolation, or the secant when only two points are distinct
+                double p, q;
+                const double s = fb / fa;
+                if (a == c)
+                {
+                    p = 2.0 * middle * s;
+                    q = 1.0 - s;
+                }
+                else
+                {
+                    const double r = fb / fc;
+                    q = fa / fc;
+                    p = s * (2.0 * middle * q * (q - r) - (b - a) * (r - 1.0));
+                    q = (q - 1.0) * (r - 1.0) * (s - 1.0);
+                }
+                if (p > 0) q = -q;
+                p = std::abs(p);
+
+                if (2.0 * p < std::min(3.0 * middle * q - std::abs(step * q), std::abs(e * q)))
+                {
+                    e = d;
+                    d = p / q;
+                }
+                else
+                {
+                    d = e = middle;
+                }
+            }
+            else
+            {
+                d = e = middle;
+            }
+
+            a = b;
+            fa = fb;
+            b += std::abs(d) > step ? d : (middle > 0 ? step : -step);
+            fb = f(b);
+        }
+        return b;
+    }
+}
+
+BladeForces SteadySolver::cycleAveragedForces(const BladeGeometry& geometry, double angularVelocity, int samples)
+{
+    const double period = 2.0 * Util::PI / geometry.offsetCos.size();
+    double lift = 0, drag = 0, sideForce = 0, torque = 0;
+    for (int i = 0; i < samples; ++i)
+    {
+        const BladeForces sample = SolverKernel::evaluate(geometry, static_cast<float>(period * i / samples), static_cast<float>(angularVelocity));
+        lift += sample.lift;
+        drag += sample.drag;
+        sideForce += sample.sideForce;
+        torque += sample.torque;
+    }
+    return {static_cast<float>(lift / samples), static_cast<float>(drag / samples), static_cast<float>(sideForce / samples),
+            static_cast<float>(torque / samples)};
+}
+
+SteadySolution SteadySolver::solve(const Configuration& configuration, const SteadySolverSettings& settings)
+{
+    const BladeGeometry Geometry(configuration);
+    CycleAverage average{Geometry, std::max(settings.cycleSamples, 1), configuration.motorDamping()};
+    auto netTorque = [&](double angularVelocity) { return average.netTorque(angularVelocity); };
+
+    // A crossflow drives the rotor at tip speeds of the order of the freestream
+    const double freestream = std::max(magnitude(configuration.freestreamVelocity), 1.0f);
+    const double maxVelocity = settings.maxTipSpeedRatio * freestream / configuration.propellerRadius;
+    const int intervals = std::max(settings.scanIntervals, 2);
+
+    SteadySolution solution;
+    for (int i = 0; i <= intervals; ++i)
+    {
+        const double angularVelocity = -maxVelocity + 2.0 * maxVelocity * i / intervals;
+        solution.scanVelocity.push_back(static_cast<float>(angularVelocity));
+        solution.scanTorque.push_back(static_cast<float>(netTorque(angularVelocity)));
+    }
+
+    std::vector<double> roots;
+    for (int i = 0; i < intervals; ++i)
+    {
+        const double a = solution.scanVelocity[i], b = solution.scanVelocity[i + 1];
+        const double fa = solution.scanTorque[i], fb = solution.scanTorque[i + 1];
+        if (fa == 0) roots.push_back(a);
+        else if ((fa > 0) != (fb > 0) && fb != 0) roots.push_back(brent(netTorque, a, b, fa, fb, settings.tolerance));
+    }
+    if (solution.scanTorque.back() == 0) roots.push_back(solution.scanVelocity.back());
+
+    for (const double root : roots)
+    {
+        SteadyOperatingPoint point;
+        const BladeForces forces = average.forces(root);
+        point.state.angularVelocity = static_cast<float>(root);
+        point.state.lift = forces.lift;
+        point.state.drag = forces.drag + static_cast<float>(Solver::hubDrag(configuration));
+        point.state.sideForce = forces.sideForce;
+        point.state.aerodynamicTorque = forces.torque;
+        point.state.torque = static_cast<float>(forces.torque - root * average.motorDamping);
+
+        // Central difference over a step well above the root tolerance
+        const double h = std::max(1e-3 * std::abs(root), 10.0 * settings.tolerance);
+        point.torqueSlope = static_cast<float>((netTorque(root + h) - netTorque(root - h)) / (2.0 * h));
+        point.stable = point.torqueSlope < 0;
+        solution.equilibria.push_back(point);
+    }
+
+    solution.evaluations = average.evaluations;
+    return solution;
+}
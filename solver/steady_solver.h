@@ -0,0 +1,58 @@
+#ifndef _STEADY_SOLVER_H_
+#define _STEADY_SOLVER_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "configuration.h"
+#include "solution.h"
+#include "solver_kernel.h"
+
+struct SteadySolverSettings
+{
+    // Angular velocities searched, up to maxTipSpeedRatio * |freestream| / propellerRadius either way
+    float maxTipSpeedRatio = 3.0f;
+
+    // Uniform intervals of the bracketing scan, equilibria closer together than one interval can be missed
+    int scanIntervals = 24;
+
+    // Rotor positions averaged over one blade passing period, 16 puts the default rotor within 1e-4 rad/s
+    int cycleSamples = 16;
+
+    // Brent's method stops once the bracket is this narrow (rad/s)
+    float tolerance = 1e-4f;
+};
+
+struct SteadyOperatingPoint
+{
+    SteadyState state;
+
+    // d(net torque)/d(angular velocity) at the equilibrium, a disturbance decays where it is negative
+    float torqueSlope = 0;
+    bool stable = false;
+};
+
+struct SteadySolution
+{
+    // Ascending angular velocity
+    std::vector<SteadyOperatingPoint> equilibria;
+
+    // Cycle averaged net torque over the scan, for plotting
+    std::vector<float> scanVelocity, scanTorque;
+
+    // Blade element kernel calls, a transient solve makes one per time step
+    size_t evaluations = 0;
+};
+
+// Steady autorotation without the transient. The net torque, blade torque averaged over a blade passing
+// period minus the motor back-EMF term w / (Kv^2 R), is scanned over angular velocity, every sign change
+// is refined with Brent's method and the loads are averaged at each root.
+namespace SteadySolver
+{
+    SteadySolution solve(const Configuration& configuration, const SteadySolverSettings& settings = SteadySolverSettings());
+
+    // Forces averaged over one blade passing period at a fixed angular velocity, samples evenly spaced positions
+    BladeForces cycleAveragedForces(const BladeGeometry& geometry, double angularVelocity, int samples);
+}
+
+#endif // _STEADY_SOLVER_H_
@@ -0,0 +1,305 @@
+#include "surrogate.h"
+#include "solver.h"
+#include "sweep_parameter.h"
+#include "util.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <random>
+
+namespace
+{
+    constexpr uint32_t FileMagic = 0x53414350; // "PCAS"
+    constexpr uint32_t FileVersion = 2;
+
+    SurrogateOutput solveAt(const Configuration& base, const std::vector<SurrogateAxis>& axes, std::span<const float> point, SolutionPool& pool)
+    {
+        Configuration configuration = base;
+        for (size_t a = 0; a < axes.size(); ++a)
+        {
+            SweepParameters::All[axes[a].parameter].apply(configuration, point[a]);
+        }
+
+        std::atomic<float> progress = 0;
+        Solution solution = Solver::solve(configuration, progress, nullptr, nullptr, nullptr, &pool);
+        const SteadyState state = solution.steadyState();
+        pool.release(std::move(solution));
+        return {state.angularVelocity, state.drag, state.sideForce};
+    }
+
+    // Swept parameters are overwritten, so their value in the base configuration does not change the hash. The pitch
+    // offset shifts the base pitch table instead, which stays part of it.
+    uint64_t baseHash(const Configuration& configuration, const std::vector<SurrogateAxis>& axes)
+    {
+        Configuration base = configuration;
+        for (const SurrogateAxis& axis : axes) SweepParameters::All[axis.parameter].apply(base, axis.min);
+        return base.hash();
+    }
+
+    template<typename T>
+    void writeValue(std::ofstream& file, const T& value)
+    {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template<typename T>
+    void readValue(std::ifstream& file, T& value)
+    {
+        file.read(reinterpret_cast<char*>(&value), sizeof(T));
+    }
+}
+
+Surrogate Surrogate::train(const Configuration& configuration, const std::vector<SurrogateAxis>& axes, size_t validationSamples, std::atomic<float>& progress)
+{
+    Surrogate surrogate;
+    if (axes.empty() || axes.size() > MaxDimensions) return surrogate;
+    if (!std::all_of(axes.begin(), axes.end(), [](const SurrogateAxis& axis) { return axis.valid(); }))
+    {
+        std::cerr << "Surrogate axes need a maximum greater than their minimum" << std::endl;
+        return surrogate;
+    }
+    surrogate.m_axes = axes;
+    for (SurrogateAxis& axis : surrogate.m_axes) axis.nodes = std::max(axis.nodes, 2);
+    surrogate.m_baseHash = baseHash(configuration, surrogate.m_axes);
+
+    size_t nodeCount = 1;
+    for (const SurrogateAxis& axis : surrogate.m_axes) nodeCount *= axis.nodes;
+    surrogate.m_values.resize(nodeCount);
+
+    // Held out points, seeded so retraining the same axes validates against the same points
+    std::mt19937 generator(0x5eed);
+    std::vector<float> validationPoints(validationSamples * axes.size());
+    for (size_t i = 0; i < validationSamples; ++i)
+    {
+        for (size_t a = 0; a < axes.size(); ++a)
+        {
+            validationPoints[i * axes.size() + a] = std::uniform_real_distribution<float>(axes[a].min, axes[a].max)(generator);
+        }
+    }
+    std::vector<SurrogateOutput> validationValues(validationSamples);
+
+    const size_t total = nodeCount + validationSamples;
+    std::atomic<size_t> completed = 0;
+    SolutionPool pool;
+    progress = 0;
+
+    Util::parallelFor(total, [&](size_t job) {
+        if (job < nodeCount)
+        {
+            // Decode the row-major node index, last axis fastest
+            std::array<float, MaxDimensions> point = {};
+            size_t remainder = job;
+            for (size_t a = surrogate.m_axes.size(); a-- > 0;)
+            {
+                const SurrogateAxis& axis = surrogate.m_axes[a];
+                const size_t node = remainder % axis.nodes;
+                remainder /= axis.nodes;
+                point[a] = axis.min + (axis.max - axis.min) * node / (axis.nodes - 1);
+            }
+            surrogate.m_values[job] = solveAt(configuration, surrogate.m_axes, std::span<const float>(point.data(), surrogate.m_axes.size()), pool);
+        }
+        else
+        {
+            const size_t i = job - nodeCount;
+            validationValues[i] = solveAt(configuration, surrogate.m_axes, std::span<const float>(&validationPoints[i * axes.size()], axes.size()), pool);
+        }
+        progress = static_cast<float>(++completed) / total;
+    });
+
+    // Validation error
+    std::vector<SurrogateOutput> predictions(validationSamples);
+    surrogate.predict(validationPoints, predictions);
+
+    SurrogateValidation& validation = surrogate.m_validation;
+    validation.samples = validationSamples;
+    std::array<double, 3> squares = {0, 0, 0};
+    for (size_t i = 0; i < validationSamples; ++i)
+    {
+        const std::array<float, 3> errors = {
+            std::abs(predictions[i].angularVelocity - validationValues[i].angularVelocity),
+            std::abs(predictions[i].drag - validationValues[i].drag),
+            std::abs(predictions[i].sideForce - validationValues[i].sideForce)
+        };
+        validation.maxError.angularVelocity = std::max(validation.maxError.angularVelocity, errors[0]);
+        validation.maxError.drag = std::max(validation.maxError.drag, errors[1]);
+        validation.maxError.sideForce = std::max(validation.maxError.sideForce, errors[2]);
+        for (size_t k = 0; k < 3; ++k) squares[k] += errors[k] * errors[k];
+    }
+    if (validationSamples > 0)
+    {
+        validation.rmsError.angularVelocity = static_cast<float>(std::sqrt(squares[0] / validationSamples));
+        validation.rmsError.drag = static_cast<float>(std::sqrt(squares[1] / validationSamples));
+        validation.rmsError.sideForce = static_cast<float>(std::sqrt(squares[2] / validationSamples));
+    }
+
+    return surrogate;
+}
+
+SurrogateOutput Surrogate::predict(std::span<const float> point) const
+{
+    const size_t dimensions = m_axes.size();
+
+    // Catmull-Rom weights and clamped node indices of the 4 point stencil on every axis
+    std::array<std::array<float, 4>, MaxDimensions> weights;
+    std::array<std::array<size_t, 4>, MaxDimensions> indices;
+    for (size_t a = 0; a < dimensions; ++a)
+    {
+        const SurrogateAxis& axis = m_axes[a];
+        const int last = axis.nodes - 1;
+        const float u = std::clamp((point[a] - axis.min) / (axis.max - axis.min) * last, 0.0f, static_cast<float>(last));
+        const int i = std::min(static_cast<int>(u), last - 1);
+        const float t = u - i, t2 = t * t, t3 = t2 * t;
+
+        weights[a] = {0.5f * (-t + 2 * t2 - t3), 0.5f * (2 - 5 * t2 + 3 * t3), 0.5f * (t + 4 * t2 - 3 * t3), 0.5f * (t3 - t2)};
+        for (int k = 0; k < 4; ++k) indices[a][k] = std::clamp(i - 1 + k, 0, last);
+    }
+
+    SurrogateOutput result;
+    const size_t stencil = size_t(1) << (2 * dimensions); // 4^dimensions
+    for (size_t s = 0; s < stencil; ++s)
+    {
+        float weight = 1;
+        size_t flat = 0;
+        for (size_t a = 0; a < dimensions; ++a)
+        {
+            const size_t k = (s >> (2 * a)) & 3;
+            weight *= weights[a][k];
+            flat = flat * m_axes[a].nodes + indices[a][k];
+        }
+
+        const SurrogateOutput& value = m_values[flat];
+        result.angularVelocity += weight * value.angularVelocity;
+        result.drag += weight * value.drag;
+        result.sideForce += weight * value.sideForce;
+    }
+    return result;
+}
+
+void Surrogate::predict(std::span<const float> points, std::span<SurrogateOutput> outputs) const
+{
+    const size_t dimensions = m_axes.size();
+    const size_t count = dimensions > 0 ? std::min(outputs.size(), points.size() / dimensions) : 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        outputs[i] = predict(points.subspan(i * dimensions, dimensions));
+    }
+}
+
+bool Surrogate::save(const std::string& filepath) const
+{
+    std::ofstream file(filepath, std::ios::binary);
+    if (!file.is_open())
+    {
+        std::cerr << "Error opening file for writing: " << filepath << std::endl;
+        return false;
+    }
+
+    writeValue(file, FileMagic);
+    writeValue(file, FileVersion);
+    writeValue(file, static_cast<uint32_t>(m_axes.size()));
+    for (const SurrogateAxis& axis : m_axes)
+    {
+        writeValue(file, static_cast<int32_t>(axis.parameter));
+        writeValue(file, axis.min);
+        writeValue(file, axis.max);
+        writeValue(file, static_cast<int32_t>(axis.nodes));
+    }
+    writeValue(file, m_baseHash);
+    writeValue(file, static_cast<uint64_t>(m_values.size()));
+    file.write(reinterpret_cast<const char*>(m_values.data()), m_values.size() * sizeof(SurrogateOutput));
+    writeValue(file, static_cast<uint64_t>(m_validation.samples));
+    writeValue(file, m_validation.rmsError);
+    writeValue(file, m_validation.maxError);
+
+    if (!file)
+    {
+        std::cerr << "Error writing file: " << filepath << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool Surrogate::load(const std::string& filepath)
+{
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file.is_open())
+    {
+        std::cerr << "Error opening file for reading: " << filepath << std::endl;
+        return false;
+    }
+
+    uint32_t magic = 0, version = 0, dimensions = 0;
+    readValue(file, magic);
+    readValue(file, version);
+    readValue(file, dimensions);
+    if (!file || magic != FileMagic || dimensions == 0 || dimensions > MaxDimensions)
+    {
+        std::cerr << "Not a surrogate model file: " << filepath << std::endl;
+        return false;
+    }
+    if (version != FileVersion)
+    {
+        // Version 1 files do not record the configuration they were trained around, they have to be retrained
+        std::cerr << "Unsupported surrogate model file version " << version << ": " << filepath << std::endl;
+        return false;
+    }
+
+    std::vector<SurrogateAxis> axes(dimensions);
+    size_t nodeCount = 1;
+    for (SurrogateAxis& axis : axes)
+    {
+        int32_t parameter = 0, nodes = 0;
+        readValue(file, parameter);
+        readValue(file, axis.min);
+        readValue(file, axis.max);
+        readValue(file, nodes);
+        axis.parameter = parameter;
+        axis.nodes = nodes;
+        if (nodes < 2 || !axis.valid() || parameter < 0 || parameter >= static_cast<int32_t>(SweepParameters::All.size()))
+        {
+            std::cerr << "Corrupt surrogate model file: " << filepath << std::endl;
+            return false;
+        }
+        nodeCount *= nodes;
+    }
+
+    uint64_t trainedHash = 0;
+    readValue(file, trainedHash);
+
+    uint64_t valueCount = 0;
+    readValue(file, valueCount);
+    if (valueCount != nodeCount)
+    {
+        std::cerr << "Corrupt surrogate model file: " << filepath << std::endl;
+        return false;
+    }
+    std::vector<SurrogateOutput> values(valueCount);
+    file.read(reinterpret_cast<char*>(values.data()), valueCount * sizeof(SurrogateOutput));
+
+    SurrogateValidation validation;
+    uint64_t samples = 0;
+    readValue(file, samples);
+    readValue(file, validation.rmsError);
+    readValue(file, validation.maxError);
+    validation.samples = samples;
+
+    if (!file)
+    {
+        std::cerr << "Error reading file: " << filepath << std::endl;
+        return false;
+    }
+
+    m_axes = std::move(axes);
+    m_values = std::move(values);
+    m_validation = validation;
+    m_baseHash = trainedHash;
+    return true;
+}
+
+bool Surrogate::trainedFor(const Configuration& configuration) const
+{
+    return baseHash(configuration, m_axes) == m_baseHash;
+}
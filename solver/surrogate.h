@@ -0,0 +1,72 @@
+#ifndef _SURROGATE_H_
+#define _SURROGATE_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "configuration.h"
+
+struct SurrogateAxis
+{
+    int parameter = 0; // Index into SweepParameters::All
+    float min = 40;
+    float max = 120;
+    int nodes = 9;
+
+    // predict() divides by the range, so an empty or NaN range is rejected everywhere an axis comes in
+    bool valid() const { return max > min; }
+};
+
+struct SurrogateOutput
+{
+    float angularVelocity = 0, drag = 0, sideForce = 0;
+};
+
+// Error of the model against full solves at random points it was not trained on
+struct SurrogateValidation
+{
+    size_t samples = 0;
+    SurrogateOutput rmsError, maxError;
+};
+
+// Steady state operating map approximated by a tensor-product Catmull-Rom spline over a regular grid of
+// full solves. Queries cost 4^dimensions table lookups, so sizing tools can afford millions of them.
+// The map only holds for the configuration it was trained around, model files record its hash.
+class Surrogate
+{
+    public:
+        static constexpr int MaxDimensions = 3;
+
+        // Solves every grid node of the axes and validationSamples random held-out points in parallel
+        static Surrogate train(const Configuration& configuration, const std::vector<SurrogateAxis>& axes, size_t validationSamples, std::atomic<float>& progress);
+
+        // point holds one value per axis
+        SurrogateOutput predict(std::span<const float> point) const;
+
+        // points is row-major, one row of dimensions() values per output. Rows missing from a short points leave
+        // their outputs untouched.
+        void predict(std::span<const float> points, std::span<SurrogateOutput> outputs) const;
+
+        bool save(const std::string& filepath) const;
+        bool load(const std::string& filepath);
+
+        // Whether configuration only differs from the one trained around in the swept parameters
+        bool trainedFor(const Configuration& configuration) const;
+
+        size_t dimensions() const { return m_axes.size(); }
+        const std::vector<SurrogateAxis>& axes() const { return m_axes; }
+        const SurrogateValidation& validation() const { return m_validation; }
+        bool empty() const { return m_values.empty(); }
+
+    private:
+        std::vector<SurrogateAxis> m_axes;
+        std::vector<SurrogateOutput> m_values; // Row-major over the axes, the last axis varies fastest
+        SurrogateValidation m_validation;
+        uint64_t m_baseHash = 0; // Hash of the training configuration with the swept parameters set to their minimum
+};
+
+#endif // _SURROGATE_H_
@@ -0,0 +1,36 @@
+#ifndef _SWEEP_PARAMETER_H_
+#define _SWEEP_PARAMETER_H_
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "configuration.h"
+#include "util.h"
+
+// A scalar Configuration parameter that sweeps, sampling and surrogate models can vary
+struct SweepParameter
+{
+    std::string name;
+    std::function<void(Configuration&, float)> apply;
+};
+
+namespace SweepParameters
+{
+    inline const std::vector<SweepParameter> All = {
+        {"Freestream Velocity (m/s)", [](Configuration& c, float v) { c.freestreamVelocity[0] = v; }},
+        {"Collective Pitch Offset (rads)", [](Configuration& c, float v) {
+            // Shifts the whole pitch table, keeping the twist distribution
+            for (float& pitch : c.bladePitch) pitch = std::clamp(pitch + v, -Util::PI / 2, Util::PI / 2);
+        }},
+        {"Air Density (kg/m^3)", [](Configuration& c, float v) { c.airDensity = v; }},
+        {"Initial Angular Velocity (rad/s)", [](Configuration& c, float v) { c.initialAngularVelocity = v; }},
+        {"Motor Resistance (ohms)", [](Configuration& c, float v) { c.motorResistance = v; }},
+        {"Motor Velocity Constant (rad/Vs)", [](Configuration& c, float v) { c.motorVelocityConstant = v; }},
+        {"Propeller Radius (m)", [](Configuration& c, float v) { c.propellerRadius = v; }},
+        {"Propeller Moment of Inertia (kgm^2)", [](Configuration& c, float v) { c.propellerMomentOfInertia = v; }}
+    };
+}
+
+#endif // _SWEEP_PARAMETER_H_
@@ -1,4 +1,11 @@
+#include "adaptive_sampler.h"
+#include "convergence.h"
+#include "distributed.h"
+#include "multi_rotor.h"
+#include "quadrature.h"
+#include "sectional_loads.h"
 #include "solution.h"
+#include "sweep_parameter.h"
 #include "util.h"
 
 #include <iomanip>
@@ -33,6 +40,8 @@ void Util::writeSolutionToCsv(const Solution& solution)
 
     solutionFile.close();
 
+    writeCycleStatisticsToCsv(solution.cycles, solution.name + "_cycles.csv");
+
     // Write configuration file
     std::string configFilename = solution.name + "_config.txt";
     std::ofstream configFile(configFilename);
@@ -48,6 +57,7 @@ void Util::writeSolutionToCsv(const Solution& solution)
     configFile << "Sim Time: " << solution.configuration.simTime << "\n";
     configFile << "Time Step: " << solution.configuration.timeStep << "\n";
     configFile << "Radial Step: " << solution.configuration.radialStep << "\n";
+    configFile << "Radial Quadrature: " << RadialQuadratureNames[static_cast<int>(solution.configuration.radialQuadrature)] << "\n";
 
     configFile << "\nFlight Conditions\n";
     configFile << "Freestream Velocity: " << solution.configuration.freestreamVelocity[0] << ", "
@@ -89,4 +99,245 @@ void Util::writeSolutionToCsv(const Solution& solution)
     configFile << "\n";
 
     configFile.close();
+}
+
+void Util::writeCycleStatisticsToCsv(const CycleStatistics& cycles, const std::string& filepath)
+{
+    std::ofstream cyclesFile(filepath);
+    if (!cyclesFile.is_open())
+    {
+        std::cerr << "Error opening file for writing: " << filepath << std::endl;
+        return;
+    }
+
+    // Write the header
+    cyclesFile << "Revolution,Start Time,Period,Angular Velocity";
+    for (const char* name : CycleSignalNames)
+    {
+        cyclesFile << "," << name << " Mean," << name << " RMS," << name << " Peak-to-Peak";
+    }
+    cyclesFile << "\n";
+
+    for (size_t r = 0; r < cycles.size(); ++r)
+    {
+        cyclesFile << std::fixed << std::setprecision(6) << r + 1 << ","
+                   << cycles.startTime[r] << ","
+                   << cycles.period[r] << ","
+                   << cycles.angularVelocity[r];
+        for (size_t s = 0; s < CycleSignalCount; ++s)
+        {
+            cyclesFile << "," << cycles.mean[s][r] << "," << cycles.rms[s][r] << "," << cycles.peakToPeak[s][r];
+        }
+        cyclesFile << "\n";
+    }
+
+    cyclesFile.close();
+}
+
+void Util::writeSweepToCsv(const SweepResult& sweep, const std::string& filepath)
+{
+    std::ofstream sweepFile(filepath);
+    if (!sweepFile.is_open())
+    {
+        std::cerr << "Error opening file for writing: " << filepath << std::endl;
+        return;
+    }
+
+    // Write the header
+    sweepFile << SweepParameters::All[sweep.settings.axes[0].parameter].name << ",";
+    if (sweep.settings.dimensions == 2) sweepFile << SweepParameters::All[sweep.settings.axes[1].parameter].name << ",";
+    sweepFile << "Depth,Angular Velocity,Aerodynamic Torque,Lift,Drag,Side Force,Revolutions,Drag Peak-to-Peak,Side Force Peak-to-Peak,Torque Peak-to-Peak\n";
+
+    for (const SweepSample& sample : sweep.samples)
+    {
+        sweepFile << std::fixed << std::setprecision(6) << sample.point[0] << ",";
+        if (sweep.settings.dimensions == 2) sweepFile << sample.point[1] << ",";
+        sweepFile << sample.depth << ","
+                  << sample.state.angularVelocity << ","
+                  << sample.state.aerodynamicTorque << ","
+                  << sample.state.lift << ","
+                  << sample.state.drag << ","
+                  << sample.state.sideForce << ","
+                  << sample.cycles.size();
+
+        // Load ripple of the last completed revolution
+        for (const CycleSignal signal : {CycleSignal::Drag, CycleSignal::SideForce, CycleSignal::Torque})
+        {
+            const std::vector<float>& peakToPeak = sample.cycles.peakToPeak[static_cast<size_t>(signal)];
+            sweepFile << "," << (peakToPeak.empty() ? 0.0f : peakToPeak.back());
+        }
+        sweepFile << "\n";
+    }
+
+    sweepFile.close();
+}
+
+void Util::writeDistributedSweepToCsv(const DistributedSweep& sweep, const std::string& filepath)
+{
+    std::ofstream sweepFile(filepath);
+    if (!sweepFile.is_open())
+    {
+        std::cerr << "Error opening file for writing: " << filepath << std::endl;
+        return;
+    }
+
+    // Write the header
+    for (const DistributedAxis& axis : sweep.axes) sweepFile << SweepParameters::All[axis.parameter].name << ",";
+    sweepFile << "Completed,Attempts,Angular Velocity,Torque,Lift,Drag,Side Force,Aerodynamic Torque,"
+              << "Min Angular Velocity,Max Angular Velocity,Max Drag,Samples\n";
+
+    // Rows are in sweep order, independent of which worker solved what
+    for (size_t i = 0; i < sweep.points.size(); ++i)
+    {
+        const DistributedResult& result = sweep.results[i];
+        const SolutionSummary& summary = result.summary;
+
+        sweepFile << std::fixed << std::setprecision(6);
+        for (const float value : sweep.points[i]) sweepFile << value << ",";
+        sweepFile << result.completed << ","
+                  << result.attempts << ","
+                  << summary.steadyState.angularVelocity << ","
+                  << summary.steadyState.torque << ","
+                  << summary.steadyState.lift << ","
+                  << summary.steadyState.drag << ","
+                  << summary.steadyState.sideForce << ","
+                  << summary.steadyState.aerodynamicTorque << ","
+                  << summary.minAngularVelocity << ","
+                  << summary.maxAngularVelocity << ","
+                  << summary.maxDrag << ","
+                  << summary.samples << "\n";
+    }
+
+    sweepFile.close();
+}
+
+void Util::writeConvergenceStudyToCsv(const ConvergenceStudy& study, const std::string& filepath)
+{
+    std::ofstream studyFile(filepath);
+    if (!studyFile.is_open())
+    {
+        std::cerr << "Error opening file for writing: " << filepath << std::endl;
+        return;
+    }
+
+    // Write the header
+    studyFile << "Time Step,Radial Step,Cost,Seconds,";
+    for (const char* name : ConvergenceOutputNames) studyFile << name << "," << name << " Relative Error,";
+    studyFile << "Within Tolerance,Recommended\n";
+
+    studyFile << std::fixed << std::setprecision(6);
+    for (size_t i = 0; i < study.cases.size(); ++i)
+    {
+        const ConvergenceCase& convergenceCase = study.cases[i];
+        studyFile << convergenceCase.timeStep << ","
+                  << convergenceCase.radialStep << ","
+                  << convergenceCase.cost << ","
+                  << convergenceCase.seconds << ",";
+        for (size_t o = 0; o < ConvergenceOutputCount; ++o)
+        {
+            studyFile << convergenceCase.values[o] << "," << std::scientific << convergenceCase.errors[o] << std::fixed << ",";
+        }
+        studyFile << convergenceCase.withinTolerance << ","
+                  << (static_cast<int>(i) == study.recommended) << "\n";
+    }
+
+    // Zero step limit the errors are measured against
+    studyFile << "0,0,,,";
+    for (size_t o = 0; o < ConvergenceOutputCount; ++o) studyFile << study.extrapolated[o] << ",,";
+    studyFile << ",\n";
+
+    studyFile.close();
+}
+
+void Util::writeMultiRotorSolutionToCsv(const MultiRotorSolution& solution, const std::string& filepath)
+{
+    std::ofstream solutionFile(filepath);
+    if (!solutionFile.is_open())
+    {
+        std::cerr << "Error opening file for writing: " << filepath << std::endl;
+        return;
+    }
+
+    // Write the header, aircraft totals then every rotor
+    solutionFile << "Time,Total Drag,Total Side Force,Total Yaw Moment";
+    for (const Solution& rotor : solution.rotors)
+    {
+        solutionFile << "," << rotor.name << " Drag," << rotor.name << " Side Force," << rotor.name << " Yaw Moment," << rotor.name << " Angular Velocity";
+    }
+    solutionFile << "\n";
+
+    solutionFile << std::fixed << std::setprecision(6);
+    for (size_t t = 0; t < solution.time.size(); ++t)
+    {
+        solutionFile << solution.time[t] << "," << solution.drag[t] << "," << solution.sideForce[t] << "," << solution.totalYawMoment[t];
+        for (size_t r = 0; r < solution.rotors.size(); ++r)
+        {
+            const Solution& rotor = solution.rotors[r];
+            solutionFile << "," << rotor.drag[t] << "," << rotor.sideForce[t] << "," << solution.yawMoment[r][t] << "," << rotor.angularVelocity[t];
+        }
+        solutionFile << "\n";
+    }
+
+    solutionFile.close();
+}
+
+bool Util::writeSectionalSliceToCsv(SectionalLoadReader& reader, SectionalChannel channel, size_t blade, size_t station,
+                                    size_t first, size_t count, const std::string& filepath)
+{
+    std::ofstream sliceFile(filepath);
+    if (!sliceFile.is_open())
+    {
+        std::cerr << "Error opening file for writing: " << filepath << std::endl;
+        return false;
+    }
+
+    // Write the header
+    sliceFile << "Time," << SectionalChannelNames[static_cast<size_t>(channel)] << "\n";
+
+    const std::vector<float> slice = reader.radialSlice(channel, blade, station, first, count);
+    for (size_t s = 0; s < slice.size(); ++s)
+    {
+        sliceFile << std::fixed << std::setprecision(6) << reader.times()[first + s] << "," << slice[s] << "\n";
+    }
+
+    sliceFile.close();
+    return true;
+}
+
+bool Util::writeSectionalWindowToCsv(SectionalLoadReader& reader, SectionalChannel channel, size_t first, size_t count, const std::string& filepath)
+{
+    std::ofstream windowFile(filepath);
+    if (!windowFile.is_open())
+    {
+        std::cerr << "Error opening file for writing: " << filepath << std::endl;
+        return false;
+    }
+
+    // Write the header
+    windowFile << "Time,Blade,Station,Radius," << SectionalChannelNames[static_cast<size_t>(channel)] << "\n";
+    if (first >= reader.samples()) return true;
+
+    // One row of time tiles at a time, whole captures need not fit in memory
+    constexpr size_t Chunk = 256;
+    const size_t last = first + std::min(count, reader.samples() - first);
+    const size_t blades = reader.blades(), stations = reader.stations();
+    for (size_t begin = first; begin < last; begin += Chunk)
+    {
+        const size_t samples = std::min(Chunk, last - begin);
+        const std::vector<float> window = reader.timeWindow(channel, begin, samples);
+        for (size_t s = 0; s < samples; ++s)
+        {
+            for (size_t b = 0; b < blades; ++b)
+            {
+                for (size_t i = 0; i < stations; ++i)
+                {
+                    windowFile << std::fixed << std::setprecision(6) << reader.times()[begin + s] << "," << b << "," << i << ","
+                               << reader.radii()[i] << "," << window[(s * blades + b) * stations + i] << "\n";
+                }
+            }
+        }
+    }
+
+    windowFile.close();
+    return true;
 }
\ No newline at end of file
@@ -3,46 +3,76 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <thread>
 #include <vector>
 
 class Solution;
+struct SweepResult;
+struct DistributedSweep;
+struct ConvergenceStudy;
+struct MultiRotorSolution;
+struct CycleStatistics;
+class SectionalLoadReader;
+enum class SectionalChannel : size_t;
 
 namespace Util
 {
     constexpr float PI = 3.14159265f;
 
+    // Fills result in place over its current size, for buffers that are reused between runs
     template<typename T>
-    std::vector<T> linspace(T start, T end, size_t N)
+    void linspace(T start, T end, std::vector<T>& result)
     {
-        std::vector<T> result(N);
+        const size_t N = result.size();
         T step = (end - start) / (N);
 
         for (size_t i = 0; i < N; ++i)
         {
             result[i] = start + i * step;
         }
+    }
 
+    template<typename T>
+    std::vector<T> linspace(T start, T end, size_t N)
+    {
+        std::vector<T> result(N);
+        linspace(start, end, result);
         return result;
     }
 
-    template <typename T>
-    std::vector<T> downsampleMinmax(const std::vector<T>& data, size_t windowSize) {
-        if (windowSize == 0 || data.size() <= 2) return data;
-
-        std::vector<T> downsampled;
-        for (size_t i = 0; i < data.size(); i += windowSize) {
-            size_t end = std::min(i + windowSize, data.size());
-            auto [min_it, max_it] = std::minmax_element(data.begin() + i, data.begin() + end);
-            downsampled.push_back(*min_it);
-            downsampled.push_back(*max_it);
-        }   
-        return downsampled;
+    // Runs body(i) for every i in [0, count) across the available hardware threads
+    template<typename Function>
+    void parallelFor(size_t count, Function&& body)
+    {
+        const size_t threads = std::min<size_t>(count, std::max(1u, std::thread::hardware_concurrency()));
+        std::atomic<size_t> next = 0;
+
+        std::vector<std::thread> workers;
+        for (size_t w = 0; w < threads; ++w)
+        {
+            workers.emplace_back([&]() {
+                for (size_t i = next++; i < count; i = next++) body(i);
+            });
+        }
+        for (std::thread& worker : workers) worker.join();
     }
 
+    // Writes the time series, the per revolution statistics next to it and the configuration
     void writeSolutionToCsv(const Solution& solution);
+    void writeCycleStatisticsToCsv(const CycleStatistics& cycles, const std::string& filepath);
+    void writeSweepToCsv(const SweepResult& sweep, const std::string& filepath);
+    void writeDistributedSweepToCsv(const DistributedSweep& sweep, const std::string& filepath);
+    void writeConvergenceStudyToCsv(const ConvergenceStudy& study, const std::string& filepath);
+    void writeMultiRotorSolutionToCsv(const MultiRotorSolution& solution, const std::string& filepath);
+
+    // Sectional load captures, only the tiles the samples [first, first + count) touch are read
+    bool writeSectionalSliceToCsv(SectionalLoadReader& reader, SectionalChannel channel, size_t blade, size_t station,
+                                  size_t first, size_t count, const std::string& filepath);
+    bool writeSectionalWindowToCsv(SectionalLoadReader& reader, SectionalChannel channel, size_t first, size_t count, const std::string& filepath);
 }
 
 #endif // _UTIL_H_
\ No newline at end of file
@@ -12,6 +12,7 @@ inline Vec3 operator*(float scalar, const Vec3& vec) noexcept;
 inline Vec3 operator/(const Vec3& vec, float scalar) noexcept;
 inline Vec3 operator+(const Vec3& a, const Vec3& b) noexcept;
 inline Vec3 operator-(const Vec3& a, const Vec3& b) noexcept;
+inline bool operator==(const Vec3& a, const Vec3& b) noexcept;
 inline Vec3 cross(const Vec3& a, const Vec3& b) noexcept;
 inline float dot(const Vec3& a, const Vec3& b) noexcept;
 inline float magnitude(const Vec3& vec) noexcept;
@@ -54,6 +55,11 @@ inline Vec3 operator-(const Vec3& a, const Vec3& b) noexcept {
     return Vec3(_mm_sub_ps(a.data, b.data));
 }
 
+// Compares x, y and z, w is padding
+inline bool operator==(const Vec3& a, const Vec3& b) noexcept {
+    return (_mm_movemask_ps(_mm_cmpeq_ps(a.data, b.data)) & 0x7) == 0x7;
+}
+
 inline Vec3 cross(const Vec3& a, const Vec3& b) noexcept {
     const auto a_yzx = _mm_shuffle_ps(a.data, a.data, _MM_SHUFFLE(3, 0, 2, 1));
     const auto b_yzx = _mm_shuffle_ps(b.data, b.data, _MM_SHUFFLE(3, 0, 2, 1));
@@ -43,6 +43,17 @@ Window::Window(const std::string& windowTitle, const int& width, const int& heig
     glfwMakeContextCurrent(m_window);
     glfwSwapInterval(1); // Vsync Enabled
 
+    // Installed before the ImGui backend, which chains to them, so any input brings back full rate rendering
+    glfwSetWindowUserPointer(m_window, this);
+    glfwSetCursorPosCallback(m_window, [](GLFWwindow* window, double, double) { onInput(window); });
+    glfwSetMouseButtonCallback(m_window, [](GLFWwindow* window, int, int, int) { onInput(window); });
+    glfwSetScrollCallback(m_window, [](GLFWwindow* window, double, double) { onInput(window); });
+    glfwSetKeyCallback(m_window, [](GLFWwindow* window, int, int, int, int) { onInput(window); });
+    glfwSetCharCallback(m_window, [](GLFWwindow* window, unsigned int) { onInput(window); });
+    glfwSetCursorEnterCallback(m_window, [](GLFWwindow* window, int) { onInput(window); });
+    glfwSetWindowFocusCallback(m_window, [](GLFWwindow* window, int) { onInput(window); });
+    glfwSetFramebufferSizeCallback(m_window, [](GLFWwindow* window, int, int) { onInput(window); });
+
     
     // Setup Dear ImGui context
     IMGUI_CHECKVERSION();
@@ -68,7 +79,7 @@ void Window::run()
     ImGuiIO& io = ImGui::GetIO();
     while (!glfwWindowShouldClose(m_window) && !m_shouldClose)
     {
-        glfwPollEvents();
+        waitForFrame();
         if (glfwGetWindowAttrib(m_window, GLFW_ICONIFIED) != 0)
         {
             ImGui_ImplGlfw_Sleep(10);
@@ -94,6 +105,14 @@ void Window::run()
     }
 }
 
+void Window::waitForFrame()
+{
+    // Redrawing unchanged frames at vsync only takes CPU time and memory bandwidth away from the solver
+    if (glfwGetTime() - m_lastInput < InteractiveHold) glfwPollEvents();
+    else if (isBusy()) glfwWaitEventsTimeout(1.0 / BusyFrameRate);
+    else glfwWaitEventsTimeout(IdleTimeout);
+}
+
 Window::~Window()
 {  
     ImGui_ImplOpenGL3_Shutdown();
@@ -111,6 +130,11 @@ inline void Window::glfw_error_callback(int error, const char* description)
     fprintf(stderr, "GLFW Error %d: %s\n", error, description);
 }
 
+void Window::onInput(GLFWwindow* window)
+{
+    static_cast<Window*>(glfwGetWindowUserPointer(window))->m_lastInput = glfwGetTime();
+}
+
 void Window::close() noexcept 
 {
     m_shouldClose = true; 
@@ -18,13 +18,30 @@ class Window {
 
     private:
         virtual void update() = 0;
+
+        // True while background work the window shows is running, frames are then redrawn at BusyFrameRate
+        virtual bool isBusy() const { return false; }
+
         static void glfw_error_callback(int error, const char* description);
+        static void onInput(GLFWwindow* window);
+        void waitForFrame();
+
+    private:
+        // Full rate rendering lasts this long after the last input, ImGui needs a few frames to settle
+        static constexpr double InteractiveHold = 0.5;
+
+        // Redraw rate while busy, enough for progress bars and live plots
+        static constexpr double BusyFrameRate = 10;
+
+        // Longest sleep with no input and nothing running
+        static constexpr double IdleTimeout = 1.0;
     
     private:
         GLFWwindow* m_window;
         const ImVec4 m_clearColor = ImVec4(0.14f, 0.14f, 0.14f, 1.00f);
         ImGuiID m_dockspaceId = 0;
         bool m_shouldClose = false;
+        double m_lastInput = 0;
 };
 
 #endif // _WINDOW_H_
\ No newline at end of file
@@ -0,0 +1,90 @@
+#include "worker_team.h"
+
+#include <xmmintrin.h>  // _mm_pause
+
+namespace
+{
+    // Polls before a worker parks, or before the caller starts yielding to workers that were descheduled.
+    // A few hundred microseconds, longer than a time step of any solve worth splitting.
+    constexpr int SpinIterations = 2000;
+}
+
+WorkerTeam::WorkerTeam(size_t workers)
+{
+    for (size_t w = 0; w < workers; ++w)
+    {
+        m_workers.emplace_back(&WorkerTeam::work, this);
+    }
+}
+
+WorkerTeam::~WorkerTeam()
+{
+    m_stop = true;
+    m_generation.fetch_add(1);
+    m_generation.notify_all();
+    for (std::thread& worker : m_workers) worker.join();
+}
+
+void WorkerTeam::dispatch(size_t count, void* context, Invoke invoke)
+{
+    if (m_workers.empty())
+    {
+        for (size_t i = 0; i < count; ++i) invoke(context, i);
+        return;
+    }
+
+    m_context = context;
+    m_invoke = invoke;
+    m_count = count;
+    m_next.store(0, std::memory_order_relaxed);
+    m_finished.store(0, std::memory_order_relaxed);
+
+    // Sequentially consistent with the workers' parked count, so either they see the new generation or we see them parked
+    m_generation.fetch_add(1);
+    if (m_parked.load() > 0) m_generation.notify_all();
+
+    drain();
+
+    // Every worker has to be out of the job before the caller's body goes out of scope
+    for (int spin = 0; m_finished.load(std::memory_order_acquire) < m_workers.size(); ++spin)
+    {
+        if (spin < SpinIterations) _mm_pause();
+        else std::this_thread::yield();
+    }
+}
+
+void WorkerTeam::drain()
+{
+    for (size_t i = m_next.fetch_add(1, std::memory_order_relaxed); i < m_count; i = m_next.fetch_add(1, std::memory_order_relaxed))
+    {
+        m_invoke(m_context, i);
+    }
+}
+
+void WorkerTeam::work()
+{
+    uint64_t seen = 0;
+    while (true)
+    {
+        uint64_t generation = m_generation.load(std::memory_order_acquire);
+        for (int spin = 0; generation == seen && spin < SpinIterations; ++spin)
+        {
+            _mm_pause();
+            generation = m_generation.load(std::memory_order_acquire);
+        }
+
+        if (generation == seen)
+        {
+            m_parked.fetch_add(1);
+            m_generation.wait(seen);
+            m_parked.fetch_sub(1);
+            continue;
+        }
+
+        seen = generation;
+        if (m_stop) return;
+
+        drain();
+        m_finished.fetch_add(1, std::memory_order_release);
+    }
+}
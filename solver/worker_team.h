@@ -0,0 +1,54 @@
+#ifndef _WORKER_TEAM_H_
+#define _WORKER_TEAM_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// Persistent threads for work too fine grained for Util::parallelFor, such as splitting a single time step.
+// Between jobs the workers spin for a short while, so back to back jobs start without a wake up, and then
+// park until the next one. The calling thread works through the job too and returns once every worker is done.
+class WorkerTeam
+{
+    public:
+        // One thread fewer than the hardware has, the caller is the last member of the team
+        explicit WorkerTeam(size_t workers = std::max(1u, std::thread::hardware_concurrency()) - 1);
+        ~WorkerTeam();
+
+        WorkerTeam(const WorkerTeam&) = delete;
+        WorkerTeam& operator=(const WorkerTeam&) = delete;
+
+        // Calls body(i) for every i in [0, count), in no particular order or thread
+        template<typename Function>
+        void run(size_t count, Function& body)
+        {
+            dispatch(count, &body, [](void* context, size_t i) { (*static_cast<Function*>(context))(i); });
+        }
+
+        size_t size() const { return m_workers.size() + 1; }
+
+    private:
+        using Invoke = void (*)(void* context, size_t i);
+
+        void dispatch(size_t count, void* context, Invoke invoke);
+        void work();
+        void drain();
+
+        std::vector<std::thread> m_workers;
+
+        // Current job, published by bumping the generation
+        void* m_context = nullptr;
+        Invoke m_invoke = nullptr;
+        size_t m_count = 0;
+        std::atomic<size_t> m_next = 0;
+        std::atomic<size_t> m_finished = 0;
+
+        std::atomic<uint64_t> m_generation = 0;
+        std::atomic<size_t> m_parked = 0;
+        std::atomic<bool> m_stop = false;
+};
+
+#endif // _WORKER_TEAM_H_
@@ -0,0 +1,117 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "distributed.h"
+#include "socket.h"
+
+// Coordinator fault handling, with the coordinator and a real worker on threads of this process and a faulty worker
+// that speaks just enough of the protocol to take a job. A worker that dies mid-job or goes silent must have its job
+// requeued and solved by the healthy worker, and a job that runs out of attempts must fail without holding up the rest.
+namespace
+{
+    using namespace std::chrono_literals;
+
+    // Protocol constants of distributed.cpp: frames are a 4 byte little-endian payload length, a type and the payload
+    constexpr uint8_t HelloMessage = 1, JobMessage = 2;
+
+    std::vector<Configuration> jobs(size_t count)
+    {
+        std::vector<Configuration> configurations(count);
+        for (size_t j = 0; j < count; ++j)
+        {
+            configurations[j].simTime = 0.05f;
+            configurations[j].timeStep = 0.005f;
+            configurations[j].radialStep = 0.1f;
+            configurations[j].freestreamVelocity[0] = 10.0f + j;
+        }
+        return configurations;
+    }
+
+    // Connects to the coordinator, says hello and waits for a job. Returns the job index, or -1 if none came.
+    long takeJob(Socket& socket, const std::string& address)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + 10s;
+        while (!(socket = Socket::connect(address)).valid())
+        {
+            if (std::chrono::steady_clock::now() > deadline) return -1;
+            std::this_thread::sleep_for(50ms);
+        }
+
+        const uint8_t hello[] = {4, 0, 0, 0, HelloMessage, Distributed::ProtocolVersion, 0, 0, 0};
+        if (!socket.sendAll(hello, sizeof(hello))) return -1;
+
+        std::vector<uint8_t> buffer;
+        while (buffer.size() < 9)
+        {
+            if (socket.receiveSome(buffer) <= 0) return -1;
+        }
+        if (buffer[4] != JobMessage) return -1;
+        return buffer[5] | buffer[6] << 8 | buffer[7] << 16 | buffer[8] << 24;
+    }
+
+    int check(bool passed, const char* claim)
+    {
+        std::printf("%s %s\n", passed ? "PASS" : "FAIL", claim);
+        return !passed;
+    }
+
+    // Runs the coordinator over count jobs. The faulty worker takes a job first, then fault() decides how it fails,
+    // then a real worker serves everything left.
+    template<typename Fault>
+    std::vector<DistributedResult> run(const char* address, size_t count, int maxAttempts, long& faultyJob, Fault fault)
+    {
+        CoordinatorSettings settings;
+        settings.address = address;
+        settings.maxAttempts = maxAttempts;
+        settings.workerTimeout = 2;
+        std::future<std::vector<DistributedResult>> coordinator = std::async(std::launch::async, Distributed::coordinate, jobs(count), settings);
+
+        Socket faulty;
+        faultyJob = takeJob(faulty, address);
+        fault(faulty);
+
+        WorkerSettings worker;
+        worker.address = address;
+        std::future<bool> healthy = std::async(std::launch::async, Distributed::work, worker);
+
+        std::vector<DistributedResult> results = coordinator.get();
+        healthy.get();
+        return results;
+    }
+}
+
+int main()
+{
+    // Unix-domain sockets in the working directory, so parallel test runs never compete for a port
+    const size_t count = 4;
+    int failures = 0;
+    long job = -1;
+
+    std::vector<DistributedResult> results = run("unix:distributed_faults_crash.sock", count, 3, job, [](Socket& socket) { socket.close(); });
+    failures += check(job >= 0, "Crashing worker received a job");
+    failures += check(std::all_of(results.begin(), results.end(), [](const DistributedResult& result) { return result.completed; }),
+                      "Every job completed after a worker died mid-job");
+    failures += check(job >= 0 && job < static_cast<long>(count) && results[job].attempts == 2, "Job of the crashed worker was requeued once");
+
+    // The silent worker keeps its connection open until the coordinator is done, only the timeout can free its job
+    Socket silent;
+    results = run("unix:distributed_faults_silent.sock", count, 3, job, [&silent](Socket& socket) { silent = std::move(socket); });
+    failures += check(std::all_of(results.begin(), results.end(), [](const DistributedResult& result) { return result.completed; }),
+                      "Every job completed after a worker went silent");
+    failures += check(job >= 0 && job < static_cast<long>(count) && results[job].attempts == 2, "Job of the silent worker was requeued after the timeout");
+    silent.close();
+
+    results = run("unix:distributed_faults_attempts.sock", count, 1, job, [](Socket& socket) { socket.close(); });
+    bool othersCompleted = job >= 0;
+    for (size_t j = 0; j < count; ++j) othersCompleted = othersCompleted && (results[j].completed || static_cast<long>(j) == job);
+    failures += check(job >= 0 && job < static_cast<long>(count) && !results[job].completed && results[job].attempts == 1,
+                      "Job of the crashed worker failed with one attempt allowed");
+    failures += check(othersCompleted, "Every other job still completed");
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,58 @@
+# Runs a small distributed sweep on several local worker processes and on a single one. Either way every job must
+# complete and the rows must come out in sweep order, so both files have to match exactly.
+# cmake -DSOLVER=<solver executable> -DWORKDIR=<scratch directory> [-DADDRESS=<socket address>] -P distributed_sweep.cmake
+
+if(NOT SOLVER OR NOT WORKDIR)
+    message(FATAL_ERROR "SOLVER and WORKDIR must be set")
+endif()
+if(NOT ADDRESS)
+    # Relative to WORKDIR, where the coordinator and its workers run, so concurrent runs never share a port or path
+    set(ADDRESS unix:coordinator.sock)
+endif()
+
+file(REMOVE_RECURSE ${WORKDIR})
+file(MAKE_DIRECTORY ${WORKDIR})
+
+# Freestream velocity 4, 6, ..., 18 m/s, exact in float so the rows can be compared as text
+set(POINTS 8)
+
+function(run_sweep workers output)
+    execute_process(COMMAND ${SOLVER} coordinator --sweep 0:4:18:${POINTS} --local ${workers} --listen ${ADDRESS}
+                            --timeout 30 --output ${WORKDIR}/${output}
+                    WORKING_DIRECTORY ${WORKDIR}
+                    RESULT_VARIABLE result
+                    TIMEOUT 240)
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "Coordinator with ${workers} local workers failed: ${result}")
+    endif()
+endfunction()
+
+run_sweep(3 parallel.csv)
+run_sweep(1 serial.csv)
+
+file(STRINGS ${WORKDIR}/parallel.csv rows)
+list(LENGTH rows count)
+math(EXPR expectedCount "${POINTS} + 1")
+if(NOT count EQUAL expectedCount)
+    message(FATAL_ERROR "Expected ${expectedCount} lines in parallel.csv, got ${count}")
+endif()
+
+list(REMOVE_AT rows 0)
+set(index 0)
+foreach(row IN LISTS rows)
+    string(REPLACE "," ";" fields "${row}")
+    list(GET fields 0 velocity)
+    list(GET fields 1 completed)
+    math(EXPR expected "4 + 2 * ${index}")
+    if(NOT velocity STREQUAL "${expected}.000000" OR NOT completed STREQUAL "1")
+        message(FATAL_ERROR "Row ${index} out of order or incomplete: ${row}")
+    endif()
+    math(EXPR index "${index} + 1")
+endforeach()
+
+file(READ ${WORKDIR}/parallel.csv parallel)
+file(READ ${WORKDIR}/serial.csv serial)
+if(NOT parallel STREQUAL serial)
+    message(FATAL_ERROR "Results of 3 workers differ from those of 1 worker")
+endif()
+message(STATUS "PASS: ${POINTS} jobs on 3 workers in sweep order, same as on 1 worker")
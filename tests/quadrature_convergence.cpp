@@ -0,0 +1,83 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+
+#include "solver.h"
+
+// Blade forces at the first step of a spinning rotor with stations placed by a quadrature scheme, against a dense
+// midpoint reference and against midpoint at the same station count. Gauss-Legendre must beat midpoint clearly on a
+// coarse blade and keep its lead in drag. Above about 16 stations the kinks of the piecewise linear chord and pitch
+// tables limit every scheme, so no advantage in torque is asserted there, and the tip-clustered cosine rule is only
+// held to midpoint's accuracy, it has no advantage on this blade.
+namespace
+{
+    struct Forces
+    {
+        float torque, drag;
+    };
+
+    Forces evaluate(RadialQuadrature quadrature, size_t stations)
+    {
+        Configuration configuration;
+        configuration.initialAngularVelocity = -4;
+        configuration.simTime = 0.002f;
+        configuration.timeStep = 0.001f;
+        configuration.radialQuadrature = quadrature;
+        configuration.radialStep = (configuration.propellerRadius - configuration.hubRadius) / stations;
+
+        std::atomic<float> progress = 0;
+        const Solution solution = Solver::solve(configuration, progress);
+        return {solution.torque[0], solution.drag[0]};
+    }
+
+    struct Errors
+    {
+        float torque, drag;
+    };
+
+    Errors errors(RadialQuadrature quadrature, size_t stations, const Forces& reference)
+    {
+        const Forces forces = evaluate(quadrature, stations);
+        return {std::abs(forces.torque - reference.torque) / std::abs(reference.torque),
+                std::abs(forces.drag - reference.drag) / std::abs(reference.drag)};
+    }
+
+    int check(bool passed, const char* claim, float value, float bound)
+    {
+        std::printf("%s %-52s %.2e <= %.2e\n", passed ? "PASS" : "FAIL", claim, value, bound);
+        return !passed;
+    }
+}
+
+int main()
+{
+    const Forces reference = evaluate(RadialQuadrature::Midpoint, 26400);
+    std::printf("Reference: torque %.6f Nm, drag %.6f N\n", reference.torque, reference.drag);
+
+    const size_t counts[] = {8, 16, 32};
+    Errors midpoint[3], gaussLegendre[3], tipCosine[3];
+    for (size_t k = 0; k < 3; ++k)
+    {
+        midpoint[k] = errors(RadialQuadrature::Midpoint, counts[k], reference);
+        gaussLegendre[k] = errors(RadialQuadrature::GaussLegendre, counts[k], reference);
+        tipCosine[k] = errors(RadialQuadrature::TipCosine, counts[k], reference);
+        std::printf("%2zu stations, torque/drag error: midpoint %.2e/%.2e, Gauss-Legendre %.2e/%.2e, tip cosine %.2e/%.2e\n", counts[k],
+                    midpoint[k].torque, midpoint[k].drag, gaussLegendre[k].torque, gaussLegendre[k].drag, tipCosine[k].torque, tipCosine[k].drag);
+    }
+
+    int failures = 0;
+    failures += check(gaussLegendre[0].torque <= midpoint[0].torque / 4, "Gauss-Legendre torque, 8 stations, <= midpoint / 4", gaussLegendre[0].torque, midpoint[0].torque / 4);
+    failures += check(gaussLegendre[0].drag <= midpoint[0].drag / 10, "Gauss-Legendre drag, 8 stations, <= midpoint / 10", gaussLegendre[0].drag, midpoint[0].drag / 10);
+    failures += check(gaussLegendre[1].drag <= midpoint[1].drag, "Gauss-Legendre drag, 16 stations, <= midpoint", gaussLegendre[1].drag, midpoint[1].drag);
+    failures += check(gaussLegendre[2].drag <= midpoint[2].drag, "Gauss-Legendre drag, 32 stations, <= midpoint", gaussLegendre[2].drag, midpoint[2].drag);
+    for (size_t k = 1; k < 3; ++k)
+    {
+        const float torqueBound = 3 * midpoint[k].torque, dragBound = 3 * std::max(midpoint[k].drag, 1e-4f);
+        failures += check(tipCosine[k].torque <= torqueBound, k == 1 ? "Tip cosine torque, 16 stations, <= 3 midpoint" : "Tip cosine torque, 32 stations, <= 3 midpoint",
+                          tipCosine[k].torque, torqueBound);
+        failures += check(tipCosine[k].drag <= dragBound, k == 1 ? "Tip cosine drag, 16 stations, <= 3 midpoint" : "Tip cosine drag, 32 stations, <= 3 midpoint",
+                          tipCosine[k].drag, dragBound);
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,142 @@
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "sectional_loads.h"
+#include "solver_kernel.h"
+
+// Blade forces with Reynolds dependent polars must match coefficientAt(pitch, |Re|) section by section, for forward
+// and reversed flow alike. Reversed sections have a negative Reynolds number, looking that up unsigned would pin
+// them to the lowest Reynolds table.
+namespace
+{
+    // The built-in polar at four Reynolds numbers, scaled by a different factor at each
+    AeroCoefficientInterpolator scaled(const AeroCoefficientInterpolator& base)
+    {
+        AeroCoefficientInterpolator::CoefficientData data;
+        const float reynolds[] = {1e4f, 1e5f, 1e6f, 1e7f};
+        for (int j = 0; j < 4; ++j)
+        {
+            std::vector<std::pair<float, float>> points = base.coefficients().begin()->second;
+            for (auto& point : points) point.second *= 0.6f + 0.3f * j;
+            data[reynolds[j]] = points;
+        }
+        return AeroCoefficientInterpolator(data);
+    }
+
+    struct Reference
+    {
+        double lift = 0, drag = 0, sideForce = 0, torque = 0;
+        int forwardSections = 0, reversedSections = 0, reversedOffLowestTable = 0;
+    };
+
+    // Same blade integral as the kernels, in double with the polars looked up directly
+    Reference reference(const BladeGeometry& geometry, float angularPosition, float angularVelocity)
+    {
+        Reference forces;
+        for (size_t b = 0; b < geometry.offsetCos.size(); ++b)
+        {
+            const double phi = std::atan2(geometry.offsetSin[b], geometry.offsetCos[b]) + angularPosition;
+            const double cosPhi = std::cos(phi), sinPhi = std::sin(phi);
+            const double freestreamTangential = geometry.freestreamY * cosPhi - geometry.freestreamX * sinPhi;
+            for (size_t i = 0; i < geometry.radii.size(); ++i)
+            {
+                const double velocity = angularVelocity * geometry.radii[i] + freestreamTangential;
+                const float reynolds = static_cast<float>(std::abs(velocity * geometry.chords[i] / geometry.kinematicViscosity));
+                const bool forward = velocity > 0;
+                const AeroCoefficientInterpolator& liftPolar = forward ? *geometry.liftPolar : *geometry.reverseLiftPolar;
+                const AeroCoefficientInterpolator& dragPolar = forward ? *geometry.dragPolar : *geometry.reverseDragPolar;
+
+                const double area = 0.5 * geometry.airDensity * velocity * velocity * geometry.chords[i] * geometry.weights[i];
+                const double sectionDrag = area * dragPolar.coefficientAt(geometry.pitches[i], reynolds) * (forward ? -1 : 1);
+                forces.lift += area * liftPolar.coefficientAt(geometry.pitches[i], reynolds);
+                forces.torque += sectionDrag * geometry.radii[i];
+                forces.drag += sinPhi * sectionDrag;
+                forces.sideForce += cosPhi * sectionDrag;
+
+                forces.forwardSections += forward;
+                forces.reversedSections += !forward;
+                forces.reversedOffLowestTable += !forward && reynolds > geometry.reverseLiftPolar->reynoldsNumbers().front();
+            }
+        }
+        return forces;
+    }
+
+    bool close(double value, double expected, double scale)
+    {
+        return std::abs(value - expected) <= 1e-4 * scale;
+    }
+}
+
+int main()
+{
+    Configuration configuration;
+    configuration.polars = std::make_shared<const PolarSet>(PolarSet{
+        scaled(AeroCoefficientInterpolator::Dae51Lift), scaled(AeroCoefficientInterpolator::Dae51Drag),
+        scaled(AeroCoefficientInterpolator::Dae51LiftReversed), scaled(AeroCoefficientInterpolator::Dae51DragReversed)});
+    const BladeGeometry geometry(configuration);
+
+    // Slow enough for the retreating blades to see reversed flow over most of their span, at changing states so the
+    // kernel's cached segments have to follow
+    int failures = 0;
+    Reference totals;
+    for (int step = 0; step < 40; ++step)
+    {
+        const float angularPosition = 0.17f * step;
+        const float angularVelocity = 20.0f + 4.0f * step;
+        const Reference expected = reference(geometry, angularPosition, angularVelocity);
+        const BladeForces forces = SolverKernel::evaluate(geometry, angularPosition, angularVelocity);
+
+        const double scale = std::abs(expected.lift) + std::abs(expected.drag) + std::abs(expected.sideForce);
+        const bool passed = close(forces.lift, expected.lift, scale) && close(forces.drag, expected.drag, scale) &&
+                            close(forces.sideForce, expected.sideForce, scale) && close(forces.torque, expected.torque, std::abs(expected.torque) + scale);
+        if (!passed)
+        {
+            std::printf("FAIL step %d: lift %.4f/%.4f drag %.4f/%.4f side force %.4f/%.4f torque %.4f/%.4f\n", step,
+                        forces.lift, expected.lift, forces.drag, expected.drag, forces.sideForce, expected.sideForce, forces.torque, expected.torque);
+        }
+        failures += !passed;
+
+        totals.forwardSections += expected.forwardSections;
+        totals.reversedSections += expected.reversedSections;
+        totals.reversedOffLowestTable += expected.reversedOffLowestTable;
+    }
+    std::printf("%s kernel: 40 states, %d forward and %d reversed sections, %d reversed above the lowest table\n", failures == 0 ? "PASS" : "FAIL",
+                totals.forwardSections, totals.reversedSections, totals.reversedOffLowestTable);
+
+    // The test is only meaningful if reversed flow actually reaches past the lowest Reynolds table
+    if (totals.forwardSections == 0 || totals.reversedOffLowestTable == 0)
+    {
+        std::printf("FAIL states do not cover forward and reversed flow above the lowest table\n");
+        ++failures;
+    }
+
+    // Section loads per unit span, the same lookups one section at a time
+    const size_t blades = geometry.offsetCos.size(), stations = geometry.radii.size(), channel = blades * stations;
+    std::vector<float> row(SectionalLoads::ChannelCount * channel);
+    const float angularPosition = 0.5f, angularVelocity = 30.0f;
+    SectionalLoads::evaluate(geometry, angularPosition, angularVelocity, row.data());
+    int sectionFailures = 0;
+    for (size_t b = 0; b < blades; ++b)
+    {
+        const double phi = std::atan2(geometry.offsetSin[b], geometry.offsetCos[b]) + angularPosition;
+        const double freestreamTangential = geometry.freestreamY * std::cos(phi) - geometry.freestreamX * std::sin(phi);
+        for (size_t i = 0; i < stations; ++i)
+        {
+            const size_t index = b * stations + i;
+            const double velocity = angularVelocity * geometry.radii[i] + freestreamTangential;
+            const float reynolds = row[static_cast<size_t>(SectionalChannel::Reynolds) * channel + index];
+            const bool forward = row[static_cast<size_t>(SectionalChannel::Forward) * channel + index] != 0;
+            const AeroCoefficientInterpolator& liftPolar = forward ? *geometry.liftPolar : *geometry.reverseLiftPolar;
+            const double expected = 0.5 * geometry.airDensity * velocity * velocity * geometry.chords[i] * liftPolar.coefficientAt(geometry.pitches[i], reynolds);
+            const double lift = row[static_cast<size_t>(SectionalChannel::Lift) * channel + index];
+            sectionFailures += !(std::abs(lift - expected) <= 1e-4 * (std::abs(expected) + 1));
+        }
+    }
+    std::printf("%s sectional loads: %d of %zu sections differ from coefficientAt(pitch, |Re|)\n", sectionFailures == 0 ? "PASS" : "FAIL",
+                sectionFailures, blades * stations);
+    failures += sectionFailures;
+
+    return failures == 0 ? 0 : 1;
+}
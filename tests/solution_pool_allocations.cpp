@@ -0,0 +1,91 @@
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include "solution_pool.h"
+#include "solver.h"
+
+// Counts every allocation of the process, and those large enough to be a solution column or pyramid level
+namespace
+{
+    std::atomic<size_t> allocations = 0, largeAllocations = 0, largeThreshold = SIZE_MAX;
+}
+
+void* operator new(size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (size >= largeThreshold.load(std::memory_order_relaxed)) largeAllocations.fetch_add(1, std::memory_order_relaxed);
+    void* pointer = std::malloc(size ? size : 1);
+    if (!pointer) throw std::bad_alloc();
+    return pointer;
+}
+
+// GCC pairs the std::free below with the operator new of every inlined standard container and reports a mismatch,
+// it does not see that operator new above allocates with std::malloc
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, size_t) noexcept { std::free(pointer); }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+namespace
+{
+    bool identical(const Solution& a, const Solution& b)
+    {
+        for (size_t f = 0; f < static_cast<size_t>(Solution::Field::Count); ++f)
+        {
+            const std::vector<float>& x = a.field(static_cast<Solution::Field>(f));
+            const std::vector<float>& y = b.field(static_cast<Solution::Field>(f));
+            if (x.size() != y.size() || std::memcmp(x.data(), y.data(), x.size() * sizeof(float)) != 0) return false;
+        }
+        return a.time == b.time;
+    }
+}
+
+// Same-length solves through a SolutionPool, as a sweep runs them. After the first run every column and pyramid
+// level must come from the released solution, and the results must match unpooled solves bit for bit.
+int main()
+{
+    constexpr int Runs = 4;
+    Configuration configuration;
+    configuration.simTime = 30;
+    const size_t TimeSteps = configuration.simTime / configuration.timeStep;
+
+    // Pyramid levels shrink geometrically, anything from a sixteenth of a column up counts as column storage
+    largeThreshold = TimeSteps * sizeof(float) / 16;
+
+    std::atomic<float> progress = 0;
+    SolutionPool pool;
+    int failures = 0;
+    for (int run = 0; run < Runs; ++run)
+    {
+        Configuration runConfiguration = configuration;
+        runConfiguration.initialAngularVelocity = 10.0f * run;
+
+        const size_t allocationsBefore = allocations, largeBefore = largeAllocations;
+        Solution pooled = Solver::solve(runConfiguration, progress, nullptr, nullptr, nullptr, &pool);
+        const size_t runAllocations = allocations - allocationsBefore, runLarge = largeAllocations - largeBefore;
+
+        const Solution unpooled = Solver::solve(runConfiguration, progress);
+        const bool same = identical(pooled, unpooled);
+        const bool passed = same && (run == 0 || runLarge == 0);
+        failures += !passed;
+
+        std::printf("%s run %d: %zu allocations, %zu column sized, %s unpooled solve\n", passed ? "PASS" : "FAIL",
+                    run, runAllocations, runLarge, same ? "identical to the" : "DIFFERENT from the");
+        pool.release(std::move(pooled));
+    }
+
+    const SolutionPool::Statistics statistics = pool.statistics();
+    const bool reused = statistics.acquired == Runs && statistics.reused == Runs - 1 && statistics.allocated == 1;
+    failures += !reused;
+    std::printf("%s pool: %zu acquired, %zu reused, %zu allocated\n", reused ? "PASS" : "FAIL", statistics.acquired, statistics.reused, statistics.allocated);
+
+    return failures == 0 ? 0 : 1;
+}